@@ -0,0 +1,481 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <network.hpp>
+#include <types.hpp>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// A lookup index for ban entries, so checking a connecting address doesn't scan the ban list
+/// Exact addresses go in a hash set and ranges (CIDR like 10.0.0.0/8 or trailing wildcards like 10.0.*.*) in a binary
+/// prefix trie per address family; patterns that are neither, such as 10.*.0.1, are kept in a short list that is scanned.
+/// Bans can carry an expiry time, kept in a min-heap so expired bans are found without scanning every ban
+class BanIndex
+{
+public:
+	/// Add a ban by its address string, as stored in BanEntry::address
+	/// @return False if the address can't be parsed or is already banned
+	bool add(StringView address)
+	{
+		Pattern pattern;
+		if (!parse(address, pattern) || patterns_.find(String(address)) != patterns_.end())
+		{
+			return false;
+		}
+		insert(pattern, 1);
+		patterns_.emplace(String(address), Stored { pattern, 0 });
+		return true;
+	}
+
+	/// Remove a ban by its address string
+	/// @return False if the address isn't banned
+	bool remove(StringView address)
+	{
+		auto it = patterns_.find(String(address));
+		if (it == patterns_.end())
+		{
+			return false;
+		}
+		insert(it->second.pattern, -1);
+		patterns_.erase(it);
+		return true;
+	}
+
+	/// Make a ban expire at a point in time
+	/// @return False if the address isn't banned
+	bool setExpiry(StringView address, TimePoint expiry)
+	{
+		auto it = patterns_.find(String(address));
+		if (it == patterns_.end())
+		{
+			return false;
+		}
+		// Earlier heap entries for this ban are skipped when popped since their generation no longer matches
+		it->second.generation = ++generation_;
+		expiries_.push_back({ expiry, it->second.generation, it->first });
+		std::push_heap(expiries_.begin(), expiries_.end(), std::greater<Expiry>());
+		return true;
+	}
+
+	/// Remove every ban that expired by a point in time, calling fn(StringView address) for each
+	/// @return The number of bans removed
+	template <typename Fn>
+	size_t removeExpired(TimePoint now, Fn fn)
+	{
+		size_t removed = 0;
+		while (!expiries_.empty() && expiries_.front().time <= now)
+		{
+			std::pop_heap(expiries_.begin(), expiries_.end(), std::greater<Expiry>());
+			const Expiry expiry = std::move(expiries_.back());
+			expiries_.pop_back();
+
+			auto it = patterns_.find(expiry.address);
+			if (it != patterns_.end() && it->second.generation == expiry.generation)
+			{
+				insert(it->second.pattern, -1);
+				patterns_.erase(it);
+				fn(StringView(expiry.address));
+				++removed;
+			}
+		}
+		return removed;
+	}
+
+	/// Check whether an address is covered by any ban
+	bool isBanned(const PeerAddress& address) const
+	{
+		if (!exact_.empty() && exact_.find(address.key()) != exact_.end())
+		{
+			return true;
+		}
+		Pattern pattern;
+		pattern.ipv6 = address.ipv6;
+		if (address.ipv6)
+		{
+			std::copy(std::begin(address.v6.bytes), std::end(address.v6.bytes), pattern.bytes.begin());
+		}
+		else
+		{
+			std::memcpy(pattern.bytes.data(), &address.v4, sizeof(address.v4));
+		}
+		pattern.prefix = address.ipv6 ? 128 : 32;
+		return matchesRange(pattern);
+	}
+
+	/// Check whether an address string is covered by any ban
+	bool isBanned(StringView address) const
+	{
+		Pattern pattern;
+		return parse(address, pattern) && matches(pattern);
+	}
+
+	void clear()
+	{
+		exact_.clear();
+		tries_[0].clear();
+		tries_[1].clear();
+		others_.clear();
+		patterns_.clear();
+		expiries_.clear();
+	}
+
+	size_t size() const
+	{
+		return patterns_.size();
+	}
+
+private:
+	/// A parsed ban; bytes are in network order, prefix is the number of leading bits that must match
+	/// and wildcards has bit i set if byte i is a wildcard not covered by the prefix
+	struct Pattern
+	{
+		StaticArray<uint8_t, 16> bytes {};
+		uint16_t wildcards = 0;
+		uint8_t prefix = 0;
+		bool ipv6 = false;
+
+		size_t length() const
+		{
+			return ipv6 ? 16 : 4;
+		}
+
+		PeerAddress::Key key() const
+		{
+			PeerAddress address;
+			address.ipv6 = ipv6;
+			if (ipv6)
+			{
+				std::copy(bytes.begin(), bytes.end(), std::begin(address.v6.bytes));
+			}
+			else
+			{
+				std::memcpy(&address.v4, bytes.data(), sizeof(address.v4));
+			}
+			return address.key();
+		}
+	};
+
+	struct Stored
+	{
+		Pattern pattern;
+		uint64_t generation;
+	};
+
+	struct Expiry
+	{
+		TimePoint time;
+		uint64_t generation;
+		String address;
+
+		bool operator>(const Expiry& other) const
+		{
+			return time > other.time;
+		}
+	};
+
+	struct TrieNode
+	{
+		StaticArray<int, 2> children { -1, -1 };
+		int bans = 0;
+	};
+
+	class Trie
+	{
+	public:
+		/// Add (delta > 0) or remove (delta < 0) a range; nodes left with no bans and no children are unlinked
+		/// on removal and their slots reused by later additions, so memory follows the number of bans
+		void add(const Pattern& pattern, int delta)
+		{
+			if (nodes_.empty())
+			{
+				nodes_.emplace_back();
+			}
+			StaticArray<int, 129> path;
+			int node = 0;
+			path[0] = node;
+			for (unsigned bit = 0; bit != pattern.prefix; ++bit)
+			{
+				const int side = (pattern.bytes[bit >> 3] >> (7 - (bit & 7))) & 1;
+				if (nodes_[node].children[side] == -1)
+				{
+					if (delta < 0)
+					{
+						return;
+					}
+					const int child = allocate();
+					nodes_[node].children[side] = child;
+				}
+				node = nodes_[node].children[side];
+				path[bit + 1] = node;
+			}
+			nodes_[node].bans += delta;
+			if (delta > 0)
+			{
+				return;
+			}
+
+			// Walk back up, unlinking nodes that no longer lead to a ban; the root is kept
+			for (unsigned bit = pattern.prefix; bit != 0; --bit)
+			{
+				TrieNode& current = nodes_[path[bit]];
+				if (current.bans > 0 || current.children[0] != -1 || current.children[1] != -1)
+				{
+					break;
+				}
+				const int side = (pattern.bytes[(bit - 1) >> 3] >> (7 - ((bit - 1) & 7))) & 1;
+				nodes_[path[bit - 1]].children[side] = -1;
+				free_.push_back(path[bit]);
+			}
+		}
+
+		bool covers(const Pattern& address) const
+		{
+			int node = nodes_.empty() ? -1 : 0;
+			for (unsigned bit = 0; node != -1; ++bit)
+			{
+				if (nodes_[node].bans > 0)
+				{
+					return true;
+				}
+				if (bit == address.prefix)
+				{
+					break;
+				}
+				node = nodes_[node].children[(address.bytes[bit >> 3] >> (7 - (bit & 7))) & 1];
+			}
+			return false;
+		}
+
+		void clear()
+		{
+			nodes_.clear();
+			free_.clear();
+		}
+
+	private:
+		int allocate()
+		{
+			if (!free_.empty())
+			{
+				const int node = free_.back();
+				free_.pop_back();
+				nodes_[node] = TrieNode();
+				return node;
+			}
+			nodes_.emplace_back();
+			return int(nodes_.size() - 1);
+		}
+
+		DynamicArray<TrieNode> nodes_;
+		DynamicArray<int> free_;
+	};
+
+	void insert(const Pattern& pattern, int delta)
+	{
+		const bool full = pattern.prefix == pattern.length() * 8;
+		if (full && !pattern.wildcards)
+		{
+			const PeerAddress::Key key = pattern.key();
+			if (delta > 0)
+			{
+				++exact_[key];
+			}
+			else if (--exact_[key] <= 0)
+			{
+				exact_.erase(key);
+			}
+		}
+		else if (!pattern.wildcards)
+		{
+			tries_[pattern.ipv6].add(pattern, delta);
+		}
+		else if (delta > 0)
+		{
+			others_.push_back(pattern);
+		}
+		else
+		{
+			auto it = std::find_if(others_.begin(), others_.end(), [&pattern](const Pattern& other)
+				{
+					return other.ipv6 == pattern.ipv6 && other.wildcards == pattern.wildcards && other.prefix == pattern.prefix && other.bytes == pattern.bytes;
+				});
+			if (it != others_.end())
+			{
+				others_.erase(it);
+			}
+		}
+	}
+
+	bool matches(const Pattern& address) const
+	{
+		return (!exact_.empty() && exact_.find(address.key()) != exact_.end()) || matchesRange(address);
+	}
+
+	bool matchesRange(const Pattern& address) const
+	{
+		if (tries_[address.ipv6].covers(address))
+		{
+			return true;
+		}
+		for (const Pattern& other : others_)
+		{
+			if (other.ipv6 != address.ipv6)
+			{
+				continue;
+			}
+			bool match = true;
+			for (size_t i = 0; match && i != other.length(); ++i)
+			{
+				if (!(other.wildcards & (1 << i)))
+				{
+					match = other.bytes[i] == address.bytes[i];
+				}
+			}
+			if (match)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// Parse an exact address, a CIDR range or an IPv4 address with * segments
+	static bool parse(StringView address, Pattern& out)
+	{
+		out = Pattern();
+		out.ipv6 = address.find(':') != StringView::npos;
+
+		StringView host = address;
+		int cidr = -1;
+		const size_t slash = address.find('/');
+		if (slash != StringView::npos)
+		{
+			host = address.substr(0, slash);
+			cidr = 0;
+			const StringView bits = address.substr(slash + 1);
+			if (bits.empty() || bits.size() > 3)
+			{
+				return false;
+			}
+			for (char c : bits)
+			{
+				if (c < '0' || c > '9')
+				{
+					return false;
+				}
+				cidr = cidr * 10 + (c - '0');
+			}
+			if (cidr > int(out.length() * 8))
+			{
+				return false;
+			}
+		}
+
+		if (out.ipv6)
+		{
+			PeerAddress parsed;
+			parsed.ipv6 = true;
+			if (!PeerAddress::FromString(parsed, String(host).c_str()))
+			{
+				return false;
+			}
+			std::copy(std::begin(parsed.v6.bytes), std::end(parsed.v6.bytes), out.bytes.begin());
+		}
+		else
+		{
+			// Parse by hand to allow * segments
+			size_t segment = 0;
+			int value = -1;
+			for (size_t i = 0; i <= host.size(); ++i)
+			{
+				const char c = i == host.size() ? '.' : host[i];
+				if (c == '.')
+				{
+					if (segment == 4 || value == -1)
+					{
+						return false;
+					}
+					if (value == 256)
+					{
+						out.wildcards |= 1 << segment;
+					}
+					else
+					{
+						out.bytes[segment] = uint8_t(value);
+					}
+					++segment;
+					value = -1;
+				}
+				else if (c == '*' && value == -1)
+				{
+					value = 256;
+				}
+				else if (c >= '0' && c <= '9' && value != 256)
+				{
+					value = (value == -1 ? 0 : value * 10) + (c - '0');
+					if (value > 255)
+					{
+						return false;
+					}
+				}
+				else
+				{
+					return false;
+				}
+			}
+			if (segment != 4)
+			{
+				return false;
+			}
+		}
+
+		out.prefix = uint8_t(cidr == -1 ? out.length() * 8 : cidr);
+		if (out.wildcards)
+		{
+			if (cidr != -1)
+			{
+				return false;
+			}
+			// Trailing wildcards are a prefix
+			unsigned trailing = 0;
+			while (trailing != 4 && (out.wildcards & (1 << (3 - trailing))))
+			{
+				++trailing;
+			}
+			if (out.wildcards == ((1 << 4) - (1 << (4 - trailing))))
+			{
+				out.prefix = uint8_t((4 - trailing) * 8);
+				out.wildcards = 0;
+			}
+		}
+
+		// Zero the bits past the prefix so equal ranges have equal keys
+		for (unsigned bit = out.prefix; bit != out.length() * 8; ++bit)
+		{
+			out.bytes[bit >> 3] &= uint8_t(~(0x80 >> (bit & 7)));
+		}
+		return true;
+	}
+
+	FlatHashMap<PeerAddress::Key, int> exact_;
+	StaticArray<Trie, 2> tries_;
+	DynamicArray<Pattern> others_;
+	FlatHashMap<String, Stored> patterns_;
+	DynamicArray<Expiry> expiries_;
+	uint64_t generation_ = 0;
+};
+
+}
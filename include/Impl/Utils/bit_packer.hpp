@@ -0,0 +1,157 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <types.hpp>
+#include <algorithm>
+#include <cstring>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// Writes values of arbitrary bit widths into a byte buffer, least significant bit first
+class BitPacker
+{
+public:
+	/// Write the low `bits` bits of a value, bits must be in [1, 32]
+	void write(uint32_t value, unsigned bits)
+	{
+		if (bits < 32)
+		{
+			value &= (uint32_t(1) << bits) - 1;
+		}
+		scratch_ |= uint64_t(value) << used_;
+		used_ += bits;
+		while (used_ >= 8)
+		{
+			data_.push_back(uint8_t(scratch_));
+			scratch_ >>= 8;
+			used_ -= 8;
+		}
+	}
+
+	void writeBit(bool value)
+	{
+		write(value, 1);
+	}
+
+	/// Write a signed value in two's complement, bits must be in [1, 32]
+	void writeSigned(int32_t value, unsigned bits)
+	{
+		write(uint32_t(value), bits);
+	}
+
+	void writeFloat(float value)
+	{
+		uint32_t raw;
+		std::memcpy(&raw, &value, sizeof(raw));
+		write(raw, 32);
+	}
+
+	/// Get the packed bytes, the last byte is padded with zero bits
+	Span<const uint8_t> bytes()
+	{
+		if (used_)
+		{
+			data_.push_back(uint8_t(scratch_));
+			scratch_ = 0;
+			used_ = 0;
+		}
+		return Span<const uint8_t>(data_.data(), data_.size());
+	}
+
+	/// Clear the contents but keep the memory
+	void reset()
+	{
+		data_.clear();
+		scratch_ = 0;
+		used_ = 0;
+	}
+
+	size_t bitCount() const
+	{
+		return data_.size() * 8 + used_;
+	}
+
+private:
+	DynamicArray<uint8_t> data_;
+	uint64_t scratch_ = 0;
+	unsigned used_ = 0;
+};
+
+/// Reads values written by BitPacker
+/// Reading past the end yields zeroes and sets the overflow flag, check it once after reading a whole message
+class BitUnpacker
+{
+public:
+	explicit BitUnpacker(Span<const uint8_t> data)
+		: data_(data)
+	{
+	}
+
+	uint32_t read(unsigned bits)
+	{
+		uint64_t value = 0;
+		unsigned got = 0;
+		while (got < bits)
+		{
+			const size_t byte = offset_ >> 3;
+			if (byte >= data_.size())
+			{
+				overflow_ = true;
+				offset_ += bits - got;
+				break;
+			}
+			const unsigned shift = offset_ & 7;
+			const unsigned take = std::min(8 - shift, bits - got);
+			value |= uint64_t((data_[byte] >> shift) & ((1u << take) - 1)) << got;
+			got += take;
+			offset_ += take;
+		}
+		return uint32_t(value);
+	}
+
+	bool readBit()
+	{
+		return read(1) != 0;
+	}
+
+	/// Read a two's complement value written with writeSigned
+	int32_t readSigned(unsigned bits)
+	{
+		const uint32_t value = read(bits);
+		if (bits < 32 && (value >> (bits - 1)) & 1)
+		{
+			return int32_t(value | ~((uint32_t(1) << bits) - 1));
+		}
+		return int32_t(value);
+	}
+
+	float readFloat()
+	{
+		const uint32_t raw = read(32);
+		float value;
+		std::memcpy(&value, &raw, sizeof(value));
+		return value;
+	}
+
+	bool overflow() const
+	{
+		return overflow_;
+	}
+
+private:
+	Span<const uint8_t> data_;
+	size_t offset_ = 0;
+	bool overflow_ = false;
+};
+
+}
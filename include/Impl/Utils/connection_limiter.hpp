@@ -0,0 +1,174 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <network.hpp>
+#include <types.hpp>
+#include <algorithm>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// A per-source token bucket limiter for incoming connection attempts
+/// Meant to run in the network layer before IPlayerPool::requestPlayer, so floods are rejected with
+/// NewConnectionResult_RateLimited before any name validation or slot allocation happens.
+/// Sources are addresses masked to a prefix (a /64 covers a whole IPv6 subnet handed to one host); at most
+/// maxSources are tracked, the least recently seen one is evicted to make room for a new one
+class ConnectionLimiter final : public NoCopy
+{
+public:
+	/// @param maxSources The number of sources to track
+	/// @param rate The number of attempts per second a source regains
+	/// @param burst The number of attempts a source can make at once
+	/// @param ipv4Prefix The number of leading bits of an IPv4 address that identify a source
+	/// @param ipv6Prefix The number of leading bits of an IPv6 address that identify a source
+	ConnectionLimiter(size_t maxSources, float rate, float burst, unsigned ipv4Prefix = 32, unsigned ipv6Prefix = 64)
+		: maxSources_(std::max<size_t>(maxSources, 1))
+		, rate_(rate)
+		, burst_(burst)
+		, ipv4Prefix_(std::min(ipv4Prefix, 32u))
+		, ipv6Prefix_(std::min(ipv6Prefix, 128u))
+	{
+		entries_.reserve(maxSources_);
+		index_.reserve(maxSources_);
+	}
+
+	/// Take one attempt from a source's bucket
+	/// @return False if the source is out of attempts and the connection should be rejected
+	bool allow(const PeerAddress& address, TimePoint now)
+	{
+		const PeerAddress::Key key = sourceKey(address);
+		uint32_t slot;
+		auto it = index_.find(key);
+		if (it != index_.end())
+		{
+			slot = it->second;
+			Entry& entry = entries_[slot];
+			const float elapsed = std::chrono::duration<float>(now - entry.last).count();
+			entry.tokens = std::min(burst_, entry.tokens + std::max(elapsed, 0.0f) * rate_);
+			entry.last = now;
+			unlink(slot);
+		}
+		else
+		{
+			if (entries_.size() < maxSources_)
+			{
+				slot = uint32_t(entries_.size());
+				entries_.emplace_back();
+			}
+			else
+			{
+				slot = tail_;
+				unlink(slot);
+				index_.erase(entries_[slot].key);
+			}
+			entries_[slot] = Entry { key, burst_, now, None, None };
+			index_.emplace(key, slot);
+		}
+		pushFront(slot);
+
+		Entry& entry = entries_[slot];
+		if (entry.tokens < 1.0f)
+		{
+			return false;
+		}
+		entry.tokens -= 1.0f;
+		return true;
+	}
+
+	/// Check a connecting peer
+	/// @return NewConnectionResult_RateLimited if it should be rejected, NewConnectionResult_Success otherwise
+	NewConnectionResult check(const PeerNetworkData& netData, TimePoint now)
+	{
+		return allow(netData.networkID.address, now) ? NewConnectionResult_Success : NewConnectionResult_RateLimited;
+	}
+
+	/// Forget every source
+	void clear()
+	{
+		entries_.clear();
+		index_.clear();
+		head_ = tail_ = None;
+	}
+
+	/// Get the number of sources being tracked
+	size_t size() const
+	{
+		return entries_.size();
+	}
+
+private:
+	static constexpr uint32_t None = ~uint32_t(0);
+
+	struct Entry
+	{
+		PeerAddress::Key key;
+		float tokens;
+		TimePoint last;
+		uint32_t prev;
+		uint32_t next;
+	};
+
+	PeerAddress::Key sourceKey(const PeerAddress& address) const
+	{
+		PeerAddress::Key key = address.key();
+		// IPv4 keys are IPv4-mapped, so their prefix starts 96 bits in; IPv6 peers in the mapped range (::ffff:a.b.c.d)
+		// are dual-stack IPv4 clients and are grouped the same way
+		const bool mapped = key.hi == 0 && (key.lo >> 32) == 0x0000ffff;
+		const unsigned prefix = address.ipv6 && !mapped ? ipv6Prefix_ : 96 + ipv4Prefix_;
+		if (prefix < 64)
+		{
+			key.hi &= prefix ? ~uint64_t(0) << (64 - prefix) : 0;
+			key.lo = 0;
+		}
+		else if (prefix < 128)
+		{
+			key.lo &= prefix > 64 ? ~uint64_t(0) << (128 - prefix) : 0;
+		}
+		return key;
+	}
+
+	void unlink(uint32_t slot)
+	{
+		Entry& entry = entries_[slot];
+		(entry.prev == None ? head_ : entries_[entry.prev].next) = entry.next;
+		(entry.next == None ? tail_ : entries_[entry.next].prev) = entry.prev;
+		entry.prev = entry.next = None;
+	}
+
+	void pushFront(uint32_t slot)
+	{
+		Entry& entry = entries_[slot];
+		entry.prev = None;
+		entry.next = head_;
+		if (head_ != None)
+		{
+			entries_[head_].prev = slot;
+		}
+		head_ = slot;
+		if (tail_ == None)
+		{
+			tail_ = slot;
+		}
+	}
+
+	size_t maxSources_;
+	float rate_;
+	float burst_;
+	unsigned ipv4Prefix_;
+	unsigned ipv6Prefix_;
+	DynamicArray<Entry> entries_;
+	FlatHashMap<PeerAddress::Key, uint32_t> index_;
+	uint32_t head_ = None;
+	uint32_t tail_ = None;
+};
+
+}
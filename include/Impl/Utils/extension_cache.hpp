@@ -0,0 +1,124 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <component.hpp>
+#include <pool.hpp>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// Extensions of a pool's entries by entry ID, so a hot queryExtension is an array load instead of a hash lookup
+/// Held by the component doing the queries, which keeps IExtensible's layout the same for every component.
+/// Only extensions added with addExtension are cached, as they live until removed or until their entry is
+/// destroyed, which clears the entry's row; whatever getExtension returns belongs to the implementation and is
+/// queried every time. An extension removed from a live entry has to be forgotten with forget.
+/// The owner has to detach from its component's onFree or free: the cache doesn't detach itself when destroyed,
+/// as a cache with static storage outlives the core and the pool's dispatcher with it.
+/// @typeparam EntryT The pool's entry type, like IPlayer
+/// @typeparam PoolSize The pool's size, like PLAYER_POOL_SIZE
+/// @typeparam MaxTypes The number of extension types cached, queries for any more aren't cached
+template <class EntryT, size_t PoolSize, size_t MaxTypes = 16>
+class ExtensionCache final : public PoolEventHandler<EntryT>, public NoCopy
+{
+public:
+	/// Start listening to a pool's destroy events, nothing is cached before this
+	void attach(IEventDispatcher<PoolEventHandler<EntryT>>& dispatcher)
+	{
+		detach();
+		dispatcher_ = &dispatcher;
+		dispatcher_->addEventHandler(this);
+	}
+
+	void detach()
+	{
+		if (dispatcher_)
+		{
+			dispatcher_->removeEventHandler(this);
+			dispatcher_ = nullptr;
+		}
+		clear();
+	}
+
+	/// Get an entry's extension, the same as queryExtension
+	template <class ExtensionT>
+	ExtensionT* query(EntryT* entry)
+	{
+		if (entry == nullptr)
+		{
+			return nullptr;
+		}
+		const size_t slot = slotOf<ExtensionT>();
+		const int id = entry->getID();
+		if (dispatcher_ == nullptr || slot >= MaxTypes || id < 0 || size_t(id) >= PoolSize)
+		{
+			return queryExtension<ExtensionT>(entry);
+		}
+		IExtension*& cached = entries_[id][slot];
+		if (cached == nullptr)
+		{
+			cached = entry->template queryAddedExtension<ExtensionT>();
+			if (cached == nullptr)
+			{
+				return queryExtension<ExtensionT>(entry);
+			}
+		}
+		return static_cast<ExtensionT*>(cached);
+	}
+
+	/// Forget an entry's cached extension, call before removing it from the entry
+	template <class ExtensionT>
+	void forget(EntryT& entry)
+	{
+		const size_t slot = slotOf<ExtensionT>();
+		const int id = entry.getID();
+		if (slot < MaxTypes && id >= 0 && size_t(id) < PoolSize)
+		{
+			entries_[id][slot] = nullptr;
+		}
+	}
+
+	void clear()
+	{
+		for (auto& row : entries_)
+		{
+			row.fill(nullptr);
+		}
+	}
+
+	void onPoolEntryDestroyed(EntryT& entry) override
+	{
+		const int id = entry.getID();
+		if (id >= 0 && size_t(id) < PoolSize)
+		{
+			entries_[id].fill(nullptr);
+		}
+	}
+
+private:
+	static size_t nextSlot()
+	{
+		static size_t next = 0;
+		return next++;
+	}
+
+	template <class ExtensionT>
+	static size_t slotOf()
+	{
+		static const size_t slot = nextSlot();
+		return slot;
+	}
+
+	IEventDispatcher<PoolEventHandler<EntryT>>* dispatcher_ = nullptr;
+	StaticArray<StaticArray<IExtension*, MaxTypes>, PoolSize> entries_ {};
+};
+
+}
@@ -0,0 +1,188 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <types.hpp>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// Builds a message in a per-thread arena, so formatting chat lines and game texts doesn't allocate
+/// Builders are used like a stack: each one takes the free space after the previous one and gives it back when
+/// destroyed, so they must not outlive the scope they were created in. They nest, but only the innermost live
+/// builder can grow; appending to an outer one while an inner one exists does nothing and marks it truncated.
+/// Text that doesn't fit is cut off.
+///
+///     MessageBuilder msg;
+///     msg.appendf("%.*s has joined the server", PRINT_VIEW(player.getName()));
+///     players.sendClientMessageToAll(Colour::White(), msg.view());
+class MessageBuilder final : public NoCopy
+{
+public:
+	static constexpr size_t ArenaSize = 16384;
+
+	MessageBuilder()
+		: start_(arena().used)
+		, length_(0)
+		, below_(arena().top)
+		, cut_(false)
+	{
+		arena().top = this;
+		data()[0] = '\0';
+		reserve();
+	}
+
+	~MessageBuilder()
+	{
+		Arena& instance = arena();
+		instance.used = start_;
+		instance.top = below_;
+	}
+
+	/// Append formatted text
+	__ATTRIBUTE__((__format__(__printf__, 2, 3)))
+	MessageBuilder& appendf(const char* fmt, ...)
+	{
+		va_list args;
+		va_start(args, fmt);
+		vappendf(fmt, args);
+		va_end(args);
+		return *this;
+	}
+
+	/// Append formatted text (receives va_list instead)
+	__ATTRIBUTE__((__format__(__printf__, 2, 0)))
+	MessageBuilder& vappendf(const char* fmt, va_list args)
+	{
+		if (!top())
+		{
+			cut_ = true;
+			return *this;
+		}
+		const size_t space = capacity() - length_;
+		if (space > 1)
+		{
+			const int written = vsnprintf(data() + length_, space, fmt, args);
+			if (written > 0)
+			{
+				grow(std::min(size_t(written), space - 1));
+			}
+		}
+		return *this;
+	}
+
+	/// Append text as is
+	MessageBuilder& append(StringView text)
+	{
+		if (!top())
+		{
+			cut_ = true;
+			return *this;
+		}
+		const size_t space = capacity() - length_;
+		if (space > 1)
+		{
+			const size_t count = std::min(text.size(), space - 1);
+			std::memcpy(data() + length_, text.data(), count);
+			grow(count);
+		}
+		return *this;
+	}
+
+	/// Get the message so far; it stays valid until the builder is changed or destroyed
+	StringView view() const
+	{
+		return StringView(data(), length_);
+	}
+
+	/// Get the message as a null terminated string
+	const char* c_str() const
+	{
+		return data();
+	}
+
+	size_t size() const
+	{
+		return length_;
+	}
+
+	/// Check whether text was cut off, because the arena ran out of space or a builder created later was live
+	bool truncated() const
+	{
+		return cut_ || length_ + 1 >= capacity();
+	}
+
+	void clear()
+	{
+		length_ = 0;
+		cut_ = false;
+		data()[0] = '\0';
+		if (top())
+		{
+			reserve();
+		}
+	}
+
+private:
+	struct Arena
+	{
+		// One spare byte for the terminator of a builder that got no space at all
+		StaticArray<char, ArenaSize + 1> data;
+		size_t used = 0;
+		/// The innermost live builder, the only one that can grow
+		const MessageBuilder* top = nullptr;
+	};
+
+	static Arena& arena()
+	{
+		static thread_local Arena instance;
+		return instance;
+	}
+
+	char* data() const
+	{
+		return arena().data.data() + start_;
+	}
+
+	bool top() const
+	{
+		return arena().top == this;
+	}
+
+	/// Only meaningful for the top builder, which owns all the space up to the end of the arena
+	size_t capacity() const
+	{
+		return ArenaSize - start_;
+	}
+
+	void reserve()
+	{
+		arena().used = std::min(start_ + length_ + 1, ArenaSize);
+	}
+
+	void grow(size_t count)
+	{
+		length_ += count;
+		data()[length_] = '\0';
+		reserve();
+	}
+
+	size_t start_;
+	size_t length_;
+	const MessageBuilder* below_;
+	bool cut_;
+};
+
+}
@@ -0,0 +1,153 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <types.hpp>
+#include <algorithm>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// A case-insensitive index of entity names, for constant time name lookups and ordered prefix searches
+/// Names are folded with ASCII rules only, matching how player names are compared; keep it up to date on
+/// connect, disconnect and name change
+template <typename T>
+class NameIndex
+{
+public:
+	/// Fold a name for comparisons
+	static String fold(StringView name)
+	{
+		String folded(name.data(), name.size());
+		for (char& c : folded)
+		{
+			if (c >= 'A' && c <= 'Z')
+			{
+				c += 'a' - 'A';
+			}
+		}
+		return folded;
+	}
+
+	/// Add an entity under a name
+	/// @return False if the name is already taken
+	bool add(StringView name, T& entity)
+	{
+		String folded = fold(name);
+		if (!byName_.emplace(folded, &entity).second)
+		{
+			return false;
+		}
+		auto pos = std::lower_bound(sorted_.begin(), sorted_.end(), folded, Less());
+		sorted_.insert(pos, Entry { std::move(folded), &entity });
+		return true;
+	}
+
+	/// Remove an entity's name
+	/// @return False if the name isn't in the index or belongs to another entity
+	bool remove(StringView name, const T& entity)
+	{
+		const String folded = fold(name);
+		auto it = byName_.find(folded);
+		if (it == byName_.end() || it->second != &entity)
+		{
+			return false;
+		}
+		byName_.erase(it);
+		auto pos = std::lower_bound(sorted_.begin(), sorted_.end(), folded, Less());
+		if (pos != sorted_.end() && pos->name == folded)
+		{
+			sorted_.erase(pos);
+		}
+		return true;
+	}
+
+	/// Move an entity to a new name
+	/// @return False if the new name is taken by another entity
+	bool rename(StringView oldName, StringView newName, T& entity)
+	{
+		T* owner = find(newName);
+		if (owner == &entity)
+		{
+			// Only the case changed, nothing to re-key
+			return true;
+		}
+		if (owner)
+		{
+			return false;
+		}
+		remove(oldName, entity);
+		return add(newName, entity);
+	}
+
+	/// Find the entity with a name, ignoring case
+	T* find(StringView name) const
+	{
+		auto it = byName_.find(fold(name));
+		return it == byName_.end() ? nullptr : it->second;
+	}
+
+	/// Check whether a name is taken by an entity other than skip
+	bool isTaken(StringView name, const T* skip = nullptr) const
+	{
+		T* owner = find(name);
+		return owner && owner != skip;
+	}
+
+	/// Find the entities whose names start with a prefix, ignoring case, in name order
+	/// @param[out] output Receives up to output.size() matches
+	/// @return The total number of matches, which may be more than what fit in output
+	size_t findPrefix(StringView prefix, Span<T*> output) const
+	{
+		const String folded = fold(prefix);
+		size_t found = 0;
+		for (auto it = std::lower_bound(sorted_.begin(), sorted_.end(), folded, Less()); it != sorted_.end() && it->name.compare(0, folded.size(), folded) == 0; ++it)
+		{
+			if (found < output.size())
+			{
+				output[found] = it->entity;
+			}
+			++found;
+		}
+		return found;
+	}
+
+	void clear()
+	{
+		byName_.clear();
+		sorted_.clear();
+	}
+
+	size_t size() const
+	{
+		return byName_.size();
+	}
+
+private:
+	struct Entry
+	{
+		String name;
+		T* entity;
+	};
+
+	struct Less
+	{
+		bool operator()(const Entry& entry, const String& name) const
+		{
+			return entry.name < name;
+		}
+	};
+
+	FlatHashMap<String, T*> byName_;
+	DynamicArray<Entry> sorted_;
+};
+
+}
@@ -0,0 +1,176 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <types.hpp>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <limits>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// A static k-d tree over a set of points, for logarithmic nearest-point and range queries
+/// Building is O(n log n), so it's meant for sets that are queried far more often than they change
+/// (such as NPC paths); rebuild it after the set is modified
+class PointTree
+{
+public:
+	/// Build the tree from a list of points, the query results are indices into this list
+	void build(Span<const Vector3> points)
+	{
+		nodes_.clear();
+		nodes_.reserve(points.size());
+		for (size_t i = 0; i != points.size(); ++i)
+		{
+			nodes_.push_back({ points[i], int(i) });
+		}
+		build(0, nodes_.size(), 0);
+	}
+
+	void clear()
+	{
+		nodes_.clear();
+	}
+
+	bool empty() const
+	{
+		return nodes_.empty();
+	}
+
+	size_t size() const
+	{
+		return nodes_.size();
+	}
+
+	/// Find the point closest to a position
+	/// @param[out] distanceSqr The squared distance to the closest point, if found
+	/// @return The index of the closest point, or -1 if the tree is empty
+	int nearest(Vector3 pos, float& distanceSqr) const
+	{
+		int best = -1;
+		distanceSqr = std::numeric_limits<float>::max();
+		nearest(0, nodes_.size(), 0, pos, best, distanceSqr);
+		return best;
+	}
+
+	/// Check whether any point is within a radius of a position
+	bool anyInRange(Vector3 pos, float radius) const
+	{
+		bool found = false;
+		forEachInRange(pos, radius, [&found](int)
+			{
+				found = true;
+				return false;
+			});
+		return found;
+	}
+
+	/// Call fn(index) for each point within a radius of a position
+	/// @param fn Return false from fn to stop the search early
+	template <typename Fn>
+	void forEachInRange(Vector3 pos, float radius, Fn fn) const
+	{
+		inRange(0, nodes_.size(), 0, pos, radius * radius, fn);
+	}
+
+private:
+	struct Node
+	{
+		Vector3 pos;
+		int index;
+	};
+
+	void build(size_t lo, size_t hi, int axis)
+	{
+		if (hi - lo < 2)
+		{
+			return;
+		}
+		const size_t mid = lo + (hi - lo) / 2;
+		std::nth_element(nodes_.begin() + lo, nodes_.begin() + mid, nodes_.begin() + hi, [axis](const Node& a, const Node& b)
+			{
+				return a.pos[axis] < b.pos[axis];
+			});
+		const int next = (axis + 1) % 3;
+		build(lo, mid, next);
+		build(mid + 1, hi, next);
+	}
+
+	void nearest(size_t lo, size_t hi, int axis, Vector3 pos, int& best, float& bestDistSqr) const
+	{
+		if (lo >= hi)
+		{
+			return;
+		}
+		const size_t mid = lo + (hi - lo) / 2;
+		const Node& node = nodes_[mid];
+		const Vector3 diff = pos - node.pos;
+		const float distSqr = glm::dot(diff, diff);
+		if (distSqr < bestDistSqr)
+		{
+			bestDistSqr = distSqr;
+			best = node.index;
+		}
+
+		const float delta = pos[axis] - node.pos[axis];
+		const int next = (axis + 1) % 3;
+		// Search the side the position is on first, the other side only if the splitting plane is closer than the best match
+		if (delta < 0.0f)
+		{
+			nearest(lo, mid, next, pos, best, bestDistSqr);
+			if (delta * delta < bestDistSqr)
+			{
+				nearest(mid + 1, hi, next, pos, best, bestDistSqr);
+			}
+		}
+		else
+		{
+			nearest(mid + 1, hi, next, pos, best, bestDistSqr);
+			if (delta * delta < bestDistSqr)
+			{
+				nearest(lo, mid, next, pos, best, bestDistSqr);
+			}
+		}
+	}
+
+	template <typename Fn>
+	bool inRange(size_t lo, size_t hi, int axis, Vector3 pos, float radiusSqr, Fn& fn) const
+	{
+		if (lo >= hi)
+		{
+			return true;
+		}
+		const size_t mid = lo + (hi - lo) / 2;
+		const Node& node = nodes_[mid];
+		const Vector3 diff = pos - node.pos;
+		if (glm::dot(diff, diff) <= radiusSqr && !fn(node.index))
+		{
+			return false;
+		}
+
+		const float delta = pos[axis] - node.pos[axis];
+		const int next = (axis + 1) % 3;
+		if ((delta <= 0.0f || delta * delta <= radiusSqr) && !inRange(lo, mid, next, pos, radiusSqr, fn))
+		{
+			return false;
+		}
+		if ((delta >= 0.0f || delta * delta <= radiusSqr) && !inRange(mid + 1, hi, next, pos, radiusSqr, fn))
+		{
+			return false;
+		}
+		return true;
+	}
+
+	DynamicArray<Node> nodes_;
+};
+
+}
@@ -0,0 +1,208 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <gtaquat.hpp>
+#include <types.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OMP_QUAT_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+#if defined(OMP_QUAT_BATCH_SSE2)
+namespace QuatBatch
+{
+	inline __m128 select(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	inline __m128 floor(__m128 x)
+	{
+		const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+		return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), _mm_set1_ps(1.0f)));
+	}
+
+	/// Sine and cosine of angles in degrees
+	/// The angle is reduced to [-45, 45] degrees before converting to radians, which is exact, so the minimax
+	/// polynomials (from Cephes) are accurate to about 1 ulp over the whole range a float can represent to 1/4 degree
+	inline void sincosDegrees(__m128 degrees, __m128& s, __m128& c)
+	{
+		const __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(degrees, _mm_set1_ps(1.0f / 90.0f)));
+		const __m128 reduced = _mm_sub_ps(degrees, _mm_mul_ps(_mm_cvtepi32_ps(quadrant), _mm_set1_ps(90.0f)));
+		const __m128 x = _mm_mul_ps(reduced, _mm_set1_ps(0.01745329251994329576923690768489f));
+		const __m128 z = _mm_mul_ps(x, x);
+
+		__m128 sinPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), z), _mm_set1_ps(8.3321608736e-3f));
+		sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(-1.6666654611e-1f));
+		sinPoly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinPoly, z), x), x);
+
+		__m128 cosPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z), _mm_set1_ps(-1.388731625493765e-3f));
+		cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(4.166664568298827e-2f));
+		cosPoly = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_mul_ps(cosPoly, z), z), _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+		// Odd quadrants swap sine and cosine, the sign bits follow from quadrant & 2 and (quadrant + 1) & 2
+		const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+		const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+		const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+		s = _mm_xor_ps(select(swap, cosPoly, sinPoly), sinSign);
+		c = _mm_xor_ps(select(swap, sinPoly, cosPoly), cosSign);
+	}
+
+	/// Arc tangent of y / x in radians, in [-pi, pi]
+	inline __m128 atan2(__m128 y, __m128 x)
+	{
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const __m128 absY = _mm_andnot_ps(signMask, y);
+		const __m128 absX = _mm_andnot_ps(signMask, x);
+
+		// Work on the first octant with the smaller magnitude on top, then unfold
+		const __m128 swap = _mm_cmpgt_ps(absY, absX);
+		const __m128 num = select(swap, absX, absY);
+		const __m128 den = select(swap, absY, absX);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 t = select(_mm_cmpeq_ps(den, zero), zero, _mm_div_ps(num, den));
+
+		// Reduce [tan(pi/8), 1] to around 0 with atan(t) = pi/4 + atan((t - 1) / (t + 1))
+		const __m128 upper = _mm_cmpgt_ps(t, _mm_set1_ps(0.4142135623730950f));
+		const __m128 u = select(upper, _mm_div_ps(_mm_sub_ps(t, _mm_set1_ps(1.0f)), _mm_add_ps(t, _mm_set1_ps(1.0f))), t);
+		const __m128 z = _mm_mul_ps(u, u);
+		__m128 poly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(8.05374449538e-2f), z), _mm_set1_ps(-1.38776856032e-1f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(1.99777106478e-1f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(-3.33329491539e-1f));
+		__m128 angle = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(poly, z), u), u);
+		angle = _mm_add_ps(angle, _mm_and_ps(upper, _mm_set1_ps(0.78539816339744830962f)));
+
+		angle = select(swap, _mm_sub_ps(_mm_set1_ps(1.57079632679489661923f), angle), angle);
+		angle = select(_mm_cmplt_ps(x, zero), _mm_sub_ps(_mm_set1_ps(3.14159265358979323846f), angle), angle);
+		return _mm_or_ps(angle, _mm_and_ps(signMask, y));
+	}
+
+	/// Arc sine in radians, computed as atan2(x, sqrt((1 - x) (1 + x))) to keep precision near +-1
+	inline __m128 asin(__m128 x)
+	{
+		const __m128 one = _mm_set1_ps(1.0f);
+		return atan2(x, _mm_sqrt_ps(_mm_mul_ps(_mm_sub_ps(one, x), _mm_add_ps(one, x))));
+	}
+
+	inline __m128 clamp(__m128 x)
+	{
+		return _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+	}
+
+	inline __m128 negDegrees(__m128 radians)
+	{
+		return _mm_mul_ps(radians, _mm_set1_ps(-57.295779513082320876798154814105f));
+	}
+
+	inline __m128 wrap(__m128 degrees)
+	{
+		const __m128 full = _mm_set1_ps(360.0f);
+		return _mm_sub_ps(degrees, _mm_mul_ps(full, floor(_mm_div_ps(degrees, full))));
+	}
+}
+#endif
+
+/// Convert a batch of Euler angles (in degrees) to quaternions, the same as GTAQuat(Vector3) for each element
+/// Quaternion components are within GTAQuat's epsilon of the scalar conversion
+/// @param[out] quats Must be at least as long as degrees
+inline void eulerToQuats(Span<const Vector3> degrees, Span<GTAQuat> quats)
+{
+	size_t i = 0;
+#if defined(OMP_QUAT_BATCH_SSE2)
+	alignas(16) float in[3][4];
+	alignas(16) float out[4][4];
+	for (; i + 4 <= degrees.size(); i += 4)
+	{
+		for (int j = 0; j != 4; ++j)
+		{
+			in[0][j] = degrees[i + j].x;
+			in[1][j] = degrees[i + j].y;
+			in[2][j] = degrees[i + j].z;
+		}
+		__m128 sx, sy, sz, cx, cy, cz;
+		const __m128 half = _mm_set1_ps(-0.5f);
+		QuatBatch::sincosDegrees(_mm_mul_ps(_mm_load_ps(in[0]), half), sx, cx);
+		QuatBatch::sincosDegrees(_mm_mul_ps(_mm_load_ps(in[1]), half), sy, cy);
+		QuatBatch::sincosDegrees(_mm_mul_ps(_mm_load_ps(in[2]), half), sz, cz);
+
+		_mm_store_ps(out[0], _mm_add_ps(_mm_mul_ps(_mm_mul_ps(cx, cy), cz), _mm_mul_ps(_mm_mul_ps(sx, sy), sz)));
+		_mm_store_ps(out[1], _mm_add_ps(_mm_mul_ps(_mm_mul_ps(cx, sy), sz), _mm_mul_ps(_mm_mul_ps(sx, cy), cz)));
+		_mm_store_ps(out[2], _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(cx, sy), cz), _mm_mul_ps(_mm_mul_ps(sx, cy), sz)));
+		_mm_store_ps(out[3], _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(cx, cy), sz), _mm_mul_ps(_mm_mul_ps(sx, sy), cz)));
+		for (int j = 0; j != 4; ++j)
+		{
+			quats[i + j] = GTAQuat(out[0][j], out[1][j], out[2][j], out[3][j]);
+		}
+	}
+#endif
+	for (; i != degrees.size(); ++i)
+	{
+		quats[i] = GTAQuat(degrees[i]);
+	}
+}
+
+/// Convert a batch of quaternions to Euler angles (in degrees), the same as GTAQuat::ToEuler for each element
+/// Gimbal lock is detected with the same epsilon as the scalar conversion; angles agree with it to within
+/// a few float ulps of the result
+/// @param[out] degrees Must be at least as long as quats
+inline void quatsToEuler(Span<const GTAQuat> quats, Span<Vector3> degrees)
+{
+	size_t i = 0;
+#if defined(OMP_QUAT_BATCH_SSE2)
+	// Matches GTAQuat::EPSILON, which is private
+	static constexpr float epsilon = 0.00000202655792236328125f;
+	alignas(16) float in[4][4];
+	alignas(16) float out[3][4];
+	for (; i + 4 <= quats.size(); i += 4)
+	{
+		for (int j = 0; j != 4; ++j)
+		{
+			in[0][j] = quats[i + j].q.w;
+			in[1][j] = quats[i + j].q.x;
+			in[2][j] = quats[i + j].q.y;
+			in[3][j] = quats[i + j].q.z;
+		}
+		using namespace QuatBatch;
+		const __m128 w = _mm_load_ps(in[0]), x = _mm_load_ps(in[1]), y = _mm_load_ps(in[2]), z = _mm_load_ps(in[3]);
+		const __m128 two = _mm_set1_ps(2.0f), half = _mm_set1_ps(0.5f);
+		const __m128 temp = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(two, y), z), _mm_mul_ps(_mm_mul_ps(two, x), w));
+		const __m128 limit = _mm_set1_ps(1.0f - epsilon);
+		const __m128 up = _mm_cmpge_ps(temp, limit);
+		const __m128 down = _mm_cmpge_ps(_mm_sub_ps(_mm_setzero_ps(), temp), limit);
+		const __m128 locked = _mm_or_ps(up, down);
+
+		const __m128 rx = select(up, _mm_set1_ps(90.0f), select(down, _mm_set1_ps(-90.0f), _mm_mul_ps(asin(clamp(temp)), _mm_set1_ps(57.295779513082320876798154814105f))));
+		const __m128 ry = select(locked, negDegrees(QuatBatch::atan2(clamp(y), clamp(w))),
+			negDegrees(QuatBatch::atan2(clamp(_mm_add_ps(_mm_mul_ps(x, z), _mm_mul_ps(y, w))), clamp(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x, x)), _mm_mul_ps(y, y))))));
+		const __m128 rz = select(locked, negDegrees(QuatBatch::atan2(clamp(z), clamp(w))),
+			negDegrees(QuatBatch::atan2(clamp(_mm_add_ps(_mm_mul_ps(x, y), _mm_mul_ps(z, w))), clamp(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x, x)), _mm_mul_ps(z, z))))));
+
+		_mm_store_ps(out[0], wrap(rx));
+		_mm_store_ps(out[1], wrap(ry));
+		_mm_store_ps(out[2], wrap(rz));
+		for (int j = 0; j != 4; ++j)
+		{
+			degrees[i + j] = Vector3(out[0][j], out[1][j], out[2][j]);
+		}
+	}
+#endif
+	for (; i != quats.size(); ++i)
+	{
+		degrees[i] = quats[i].ToEuler();
+	}
+}
+
+}
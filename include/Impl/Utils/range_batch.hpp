@@ -0,0 +1,230 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <types.hpp>
+#include <bitset>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OMP_RANGE_BATCH_SSE2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define OMP_RANGE_BATCH_AVX2_TARGET
+#else
+#define OMP_RANGE_BATCH_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OMP_RANGE_BATCH_NEON
+#include <arm_neon.h>
+#endif
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+namespace RangeBatch
+{
+	/// Check the candidates in [from, to) one at a time, the fallback for the tail of a batch
+	inline void scalar(Vector3 origin, int world, float radiusSqr, const Vector3* positions, const int* worlds, size_t from, size_t to, uint64_t* mask)
+	{
+		for (size_t i = from; i != to; ++i)
+		{
+			const Vector3 diff = positions[i] - origin;
+			if ((!worlds || worlds[i] == world) && glm::dot(diff, diff) <= radiusSqr)
+			{
+				mask[i >> 6] |= uint64_t(1) << (i & 63);
+			}
+		}
+	}
+
+	using Kernel = size_t (*)(Vector3, int, float, const Vector3*, const int*, size_t, uint64_t*);
+
+#if defined(OMP_RANGE_BATCH_SSE2)
+	/// Split four packed Vector3s (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3) into one register per axis
+	/// Works on each 128 bit lane, so the AVX2 kernel uses the same shuffles on two groups at once
+#define OMP_RANGE_BATCH_TRANSPOSE(shuffle, a, b, c, x, y, z)                                      \
+	x = shuffle(shuffle(a, a, _MM_SHUFFLE(3, 3, 0, 0)), shuffle(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)); \
+	y = shuffle(shuffle(a, b, _MM_SHUFFLE(0, 0, 1, 1)), shuffle(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)); \
+	z = shuffle(shuffle(a, b, _MM_SHUFFLE(1, 1, 2, 2)), shuffle(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0))
+
+	inline size_t sse2(Vector3 origin, int world, float radiusSqr, const Vector3* positions, const int* worlds, size_t count, uint64_t* mask)
+	{
+		const float* data = reinterpret_cast<const float*>(positions);
+		const __m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+		const __m128 radius = _mm_set1_ps(radiusSqr);
+		const __m128i vw = _mm_set1_epi32(world);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 a = _mm_loadu_ps(data + i * 3);
+			const __m128 b = _mm_loadu_ps(data + i * 3 + 4);
+			const __m128 c = _mm_loadu_ps(data + i * 3 + 8);
+			__m128 x, y, z;
+			OMP_RANGE_BATCH_TRANSPOSE(_mm_shuffle_ps, a, b, c, x, y, z);
+			x = _mm_sub_ps(x, ox);
+			y = _mm_sub_ps(y, oy);
+			z = _mm_sub_ps(z, oz);
+			const __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+			__m128 in = _mm_cmple_ps(dist, radius);
+			if (worlds)
+			{
+				in = _mm_and_ps(in, _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(worlds + i)), vw)));
+			}
+			// Groups of 4 never straddle a 64 bit word
+			mask[i >> 6] |= uint64_t(_mm_movemask_ps(in)) << (i & 63);
+		}
+		return i;
+	}
+
+	OMP_RANGE_BATCH_AVX2_TARGET inline size_t avx2(Vector3 origin, int world, float radiusSqr, const Vector3* positions, const int* worlds, size_t count, uint64_t* mask)
+	{
+		const float* data = reinterpret_cast<const float*>(positions);
+		const __m256 ox = _mm256_set1_ps(origin.x), oy = _mm256_set1_ps(origin.y), oz = _mm256_set1_ps(origin.z);
+		const __m256 radius = _mm256_set1_ps(radiusSqr);
+		const __m256i vw = _mm256_set1_epi32(world);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256 p0 = _mm256_loadu_ps(data + i * 3);
+			const __m256 p1 = _mm256_loadu_ps(data + i * 3 + 8);
+			const __m256 p2 = _mm256_loadu_ps(data + i * 3 + 16);
+			// Put points 0-3 in the low lanes and points 4-7 in the high lanes
+			const __m256 a = _mm256_permute2f128_ps(p0, p1, 0x30);
+			const __m256 b = _mm256_permute2f128_ps(p0, p2, 0x21);
+			const __m256 c = _mm256_permute2f128_ps(p1, p2, 0x30);
+			__m256 x, y, z;
+			OMP_RANGE_BATCH_TRANSPOSE(_mm256_shuffle_ps, a, b, c, x, y, z);
+			x = _mm256_sub_ps(x, ox);
+			y = _mm256_sub_ps(y, oy);
+			z = _mm256_sub_ps(z, oz);
+			const __m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+			__m256 in = _mm256_cmp_ps(dist, radius, _CMP_LE_OQ);
+			if (worlds)
+			{
+				in = _mm256_and_ps(in, _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(worlds + i)), vw)));
+			}
+			mask[i >> 6] |= uint64_t(_mm256_movemask_ps(in)) << (i & 63);
+		}
+		return i;
+	}
+
+#undef OMP_RANGE_BATCH_TRANSPOSE
+
+	inline bool hasAVX2()
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+		{
+			return false;
+		}
+		__cpuid(info, 1);
+		// The OS has to save the YMM registers on context switches
+		if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6)
+		{
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+
+	inline Kernel select()
+	{
+		return hasAVX2() ? &avx2 : &sse2;
+	}
+#elif defined(OMP_RANGE_BATCH_NEON)
+	inline size_t neon(Vector3 origin, int world, float radiusSqr, const Vector3* positions, const int* worlds, size_t count, uint64_t* mask)
+	{
+		const float* data = reinterpret_cast<const float*>(positions);
+		const float32x4_t radius = vdupq_n_f32(radiusSqr);
+		const int32x4_t vw = vdupq_n_s32(world);
+		static const uint32_t bits[4] = { 1, 2, 4, 8 };
+		const uint32x4_t weights = vld1q_u32(bits);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			// vld3q splits the packed Vector3s into one register per axis by itself
+			const float32x4x3_t p = vld3q_f32(data + i * 3);
+			const float32x4_t x = vsubq_f32(p.val[0], vdupq_n_f32(origin.x));
+			const float32x4_t y = vsubq_f32(p.val[1], vdupq_n_f32(origin.y));
+			const float32x4_t z = vsubq_f32(p.val[2], vdupq_n_f32(origin.z));
+			const float32x4_t dist = vmlaq_f32(vmlaq_f32(vmulq_f32(x, x), y, y), z, z);
+			uint32x4_t in = vcleq_f32(dist, radius);
+			if (worlds)
+			{
+				in = vandq_u32(in, vceqq_s32(vld1q_s32(worlds + i), vw));
+			}
+			const uint32x4_t set = vandq_u32(in, weights);
+			const uint32x2_t half = vadd_u32(vget_low_u32(set), vget_high_u32(set));
+			mask[i >> 6] |= uint64_t(vget_lane_u32(vpadd_u32(half, half), 0)) << (i & 63);
+		}
+		return i;
+	}
+
+	inline Kernel select()
+	{
+		return &neon;
+	}
+#else
+	inline Kernel select()
+	{
+		return nullptr;
+	}
+#endif
+}
+
+/// Get the number of 64 bit words needed for the mask of a batch of candidates
+inline size_t rangeMaskSize(size_t count)
+{
+	return (count + 63) / 64;
+}
+
+/// Check a batch of candidate positions against a radius around an origin
+/// Uses SSE2 on x86 (AVX2 when the CPU supports it, detected once) and NEON on ARM
+/// @param worlds The candidates' virtual worlds, must be as long as positions; pass an empty span to ignore worlds
+/// @param[out] mask Bit i (word i / 64, bit i % 64) is set if candidate i is within the radius and in the same world,
+/// must hold at least rangeMaskSize(positions.size()) words
+/// @return The number of candidates in range
+inline size_t findInRange(Vector3 origin, int world, float radius, Span<const Vector3> positions, Span<const int> worlds, Span<uint64_t> mask)
+{
+	static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 must be tightly packed");
+	static const RangeBatch::Kernel kernel = RangeBatch::select();
+
+	const size_t count = positions.size();
+	const size_t words = rangeMaskSize(count);
+	for (size_t i = 0; i != words; ++i)
+	{
+		mask[i] = 0;
+	}
+
+	const float radiusSqr = radius * radius;
+	const int* worldData = worlds.empty() ? nullptr : worlds.data();
+	size_t done = 0;
+	if (kernel)
+	{
+		done = kernel(origin, world, radiusSqr, positions.data(), worldData, count, mask.data());
+	}
+	RangeBatch::scalar(origin, world, radiusSqr, positions.data(), worldData, done, count, mask.data());
+
+	size_t found = 0;
+	for (size_t i = 0; i != words; ++i)
+	{
+		found += std::bitset<64>(mask[i]).count();
+	}
+	return found;
+}
+
+}
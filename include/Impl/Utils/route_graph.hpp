@@ -0,0 +1,329 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include "point_tree.hpp"
+#include <algorithm>
+#include <functional>
+#include <list>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// A weighted directed graph of positioned nodes stored as compressed adjacency lists
+/// Fill it with addNode/addLink then call finalise; after that it is read-only and may be searched from several
+/// threads at once, each using its own RouteSearch
+class RouteGraph
+{
+public:
+	/// Add a node and get its index
+	int addNode(Vector3 pos)
+	{
+		positions_.push_back(pos);
+		return int(positions_.size()) - 1;
+	}
+
+	/// Add a one-way link between two nodes, the cost defaults to the distance between them
+	void addLink(int from, int to, float cost = -1.0f)
+	{
+		if (cost < 0.0f)
+		{
+			cost = glm::distance(positions_[from], positions_[to]);
+		}
+		pending_.push_back({ from, to, cost });
+	}
+
+	/// Build the adjacency lists and the spatial index
+	void finalise()
+	{
+		std::sort(pending_.begin(), pending_.end(), [](const PendingLink& a, const PendingLink& b)
+			{
+				return a.from < b.from;
+			});
+		offsets_.assign(positions_.size() + 1, 0);
+		links_.clear();
+		links_.reserve(pending_.size());
+		for (const PendingLink& link : pending_)
+		{
+			++offsets_[link.from + 1];
+			links_.push_back({ link.to, link.cost });
+		}
+		for (size_t i = 1; i < offsets_.size(); ++i)
+		{
+			offsets_[i] += offsets_[i - 1];
+		}
+		pending_.clear();
+		pending_.shrink_to_fit();
+		tree_.build(positions_);
+	}
+
+	void clear()
+	{
+		positions_.clear();
+		offsets_.clear();
+		links_.clear();
+		pending_.clear();
+		tree_.clear();
+	}
+
+	size_t size() const
+	{
+		return positions_.size();
+	}
+
+	Vector3 position(int node) const
+	{
+		return positions_[node];
+	}
+
+	/// Find the node closest to a position
+	/// @return The node index, or -1 if the graph is empty or the closest node is further than maxDistance
+	int nearestNode(Vector3 pos, float maxDistance = std::numeric_limits<float>::max()) const
+	{
+		float distanceSqr;
+		const int node = tree_.nearest(pos, distanceSqr);
+		if (node == -1 || distanceSqr > maxDistance * maxDistance)
+		{
+			return -1;
+		}
+		return node;
+	}
+
+private:
+	friend class RouteSearch;
+
+	struct Link
+	{
+		int to;
+		float cost;
+	};
+
+	struct PendingLink
+	{
+		int from;
+		int to;
+		float cost;
+	};
+
+	DynamicArray<Vector3> positions_;
+	DynamicArray<uint32_t> offsets_;
+	DynamicArray<Link> links_;
+	DynamicArray<PendingLink> pending_;
+	PointTree tree_;
+};
+
+/// Scratch state for A* searches over a RouteGraph
+/// Keep one per searching thread; the buffers are stamped with a search number so they are never cleared between searches
+class RouteSearch
+{
+public:
+	/// Find the cheapest route between two nodes
+	/// @param[out] route The nodes of the route, from start to goal inclusive
+	/// @param maxVisits Give up after expanding this many nodes, 0 for no limit
+	/// @return False if the goal can't be reached
+	bool find(const RouteGraph& graph, int start, int goal, DynamicArray<int>& route, size_t maxVisits = 0)
+	{
+		route.clear();
+		if (start < 0 || goal < 0 || size_t(start) >= graph.size() || size_t(goal) >= graph.size())
+		{
+			return false;
+		}
+
+		prepare(graph.size());
+		const Vector3 target = graph.position(goal);
+		open_.clear();
+		touch(start, 0.0f, -1);
+		push(start, glm::distance(graph.position(start), target));
+
+		size_t visits = 0;
+		while (!open_.empty())
+		{
+			const Open current = open_.front();
+			std::pop_heap(open_.begin(), open_.end(), std::greater<Open>());
+			open_.pop_back();
+
+			State& state = states_[current.node];
+			if (state.closed)
+			{
+				continue;
+			}
+			if (current.node == goal)
+			{
+				for (int node = goal; node != -1; node = states_[node].parent)
+				{
+					route.push_back(node);
+				}
+				std::reverse(route.begin(), route.end());
+				return true;
+			}
+			state.closed = true;
+			if (maxVisits && ++visits > maxVisits)
+			{
+				return false;
+			}
+
+			for (uint32_t i = graph.offsets_[current.node], end = graph.offsets_[current.node + 1]; i != end; ++i)
+			{
+				const RouteGraph::Link& link = graph.links_[i];
+				const float cost = state.cost + link.cost;
+				State& next = states_[link.to];
+				if (next.stamp != stamp_ || cost < next.cost)
+				{
+					touch(link.to, cost, current.node);
+					push(link.to, cost + glm::distance(graph.position(link.to), target));
+				}
+			}
+		}
+		return false;
+	}
+
+private:
+	struct State
+	{
+		float cost;
+		int parent;
+		uint32_t stamp;
+		bool closed;
+	};
+
+	struct Open
+	{
+		float estimate;
+		int node;
+
+		bool operator>(const Open& other) const
+		{
+			return estimate > other.estimate;
+		}
+	};
+
+	void prepare(size_t size)
+	{
+		if (states_.size() < size)
+		{
+			states_.resize(size, State { 0.0f, -1, 0, false });
+		}
+		if (++stamp_ == 0)
+		{
+			// The stamp wrapped around, old stamps could match again
+			std::fill(states_.begin(), states_.end(), State { 0.0f, -1, 0, false });
+			stamp_ = 1;
+		}
+	}
+
+	void touch(int node, float cost, int parent)
+	{
+		states_[node] = State { cost, parent, stamp_, false };
+	}
+
+	void push(int node, float estimate)
+	{
+		open_.push_back({ estimate, node });
+		std::push_heap(open_.begin(), open_.end(), std::greater<Open>());
+	}
+
+	DynamicArray<State> states_;
+	DynamicArray<Open> open_;
+	uint32_t stamp_ = 0;
+};
+
+/// A bounded least-recently-used cache of routes keyed by their start and goal nodes
+class RouteCache
+{
+public:
+	explicit RouteCache(size_t capacity = 256)
+		: capacity_(capacity)
+	{
+	}
+
+	/// Get a cached route, marking it as recently used
+	/// @return nullptr if the route isn't cached
+	const DynamicArray<int>* find(int start, int goal)
+	{
+		auto it = index_.find(key(start, goal));
+		if (it == index_.end())
+		{
+			return nullptr;
+		}
+		entries_.splice(entries_.begin(), entries_, it->second);
+		return &it->second->route;
+	}
+
+	/// Cache a route, evicting the least recently used one if the cache is full
+	void insert(int start, int goal, DynamicArray<int> route)
+	{
+		if (capacity_ == 0)
+		{
+			return;
+		}
+		const uint64_t k = key(start, goal);
+		auto it = index_.find(k);
+		if (it != index_.end())
+		{
+			it->second->route = std::move(route);
+			entries_.splice(entries_.begin(), entries_, it->second);
+			return;
+		}
+		if (entries_.size() >= capacity_)
+		{
+			index_.erase(entries_.back().key);
+			entries_.pop_back();
+		}
+		entries_.push_front({ k, std::move(route) });
+		index_.emplace(k, entries_.begin());
+	}
+
+	/// Change how many routes are kept, evicting the least recently used ones that no longer fit
+	void setCapacity(size_t capacity)
+	{
+		capacity_ = capacity;
+		while (entries_.size() > capacity_)
+		{
+			index_.erase(entries_.back().key);
+			entries_.pop_back();
+		}
+	}
+
+	size_t capacity() const
+	{
+		return capacity_;
+	}
+
+	/// Drop every cached route, call this when the graph changes
+	void clear()
+	{
+		index_.clear();
+		entries_.clear();
+	}
+
+	size_t size() const
+	{
+		return entries_.size();
+	}
+
+private:
+	struct Entry
+	{
+		uint64_t key;
+		DynamicArray<int> route;
+	};
+
+	static uint64_t key(int start, int goal)
+	{
+		return (uint64_t(uint32_t(start)) << 32) | uint32_t(goal);
+	}
+
+	size_t capacity_;
+	std::list<Entry> entries_;
+	FlatHashMap<uint64_t, std::list<Entry>::iterator> index_;
+};
+
+}
@@ -0,0 +1,163 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <types.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// A fixed set of worker threads used to split read-only per-entity work across cores
+/// The calling thread always takes part in the work, so a pool of N workers uses N + 1 threads
+/// Only one parallelFor may run at a time; it is meant to be driven from the main thread
+class WorkerPool final : public NoCopy
+{
+public:
+	/// @param count The number of extra threads to spawn, 0 runs everything on the calling thread
+	explicit WorkerPool(unsigned count)
+	{
+		workers_.reserve(count);
+		for (unsigned i = 0; i != count; ++i)
+		{
+			workers_.emplace_back(&WorkerPool::run, this);
+		}
+	}
+
+	~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopping_ = true;
+		}
+		wake_.notify_all();
+		for (std::thread& worker : workers_)
+		{
+			worker.join();
+		}
+	}
+
+	/// Get the number of extra threads in the pool
+	size_t size() const
+	{
+		return workers_.size();
+	}
+
+	/// Call fn(index) for every index in [0, count) and return once all of them are done
+	/// The order of calls is unspecified, fn must only write to state owned by its index
+	/// @param grain How many consecutive indices a thread claims at once
+	template <typename Fn>
+	void parallelFor(size_t count, Fn fn, size_t grain = 1)
+	{
+		grain = std::max<size_t>(grain, 1);
+		if (workers_.empty() || count <= grain)
+		{
+			for (size_t i = 0; i != count; ++i)
+			{
+				fn(i);
+			}
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			job_.invoke = [](void* context, size_t index)
+			{
+				(*static_cast<Fn*>(context))(index);
+			};
+			job_.context = &fn;
+			job_.count = count;
+			job_.grain = grain;
+			next_.store(0, std::memory_order_relaxed);
+			busy_ = workers_.size();
+			++generation_;
+		}
+		wake_.notify_all();
+
+		work();
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		done_.wait(lock, [this]
+			{
+				return busy_ == 0;
+			});
+	}
+
+private:
+	struct Job
+	{
+		void (*invoke)(void*, size_t) = nullptr;
+		void* context = nullptr;
+		size_t count = 0;
+		size_t grain = 1;
+	};
+
+	void work()
+	{
+		for (;;)
+		{
+			const size_t from = next_.fetch_add(job_.grain, std::memory_order_relaxed);
+			if (from >= job_.count)
+			{
+				return;
+			}
+			const size_t to = std::min(from + job_.grain, job_.count);
+			for (size_t i = from; i != to; ++i)
+			{
+				job_.invoke(job_.context, i);
+			}
+		}
+	}
+
+	void run()
+	{
+		uint64_t seen = 0;
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				wake_.wait(lock, [this, seen]
+					{
+						return stopping_ || generation_ != seen;
+					});
+				if (stopping_)
+				{
+					return;
+				}
+				seen = generation_;
+			}
+
+			work();
+
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (--busy_ == 0)
+			{
+				done_.notify_one();
+			}
+		}
+	}
+
+	DynamicArray<std::thread> workers_;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::condition_variable done_;
+	Job job_;
+	std::atomic<size_t> next_ { 0 };
+	size_t busy_ = 0;
+	uint64_t generation_ = 0;
+	bool stopping_ = false;
+};
+
+}
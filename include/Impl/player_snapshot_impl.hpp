@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../player.hpp"
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// The default IPlayerPoolSnapshot, call refresh once per tick after sync processing
+struct PlayerPoolSnapshot final : public IPlayerPoolSnapshot, public NoCopy
+{
+	unsigned tick = 0;
+	StaticArray<uint8_t, PLAYER_POOL_SIZE> present {};
+	StaticArray<Vector3, PLAYER_POOL_SIZE> positions {};
+	StaticArray<Vector3, PLAYER_POOL_SIZE> velocities {};
+	StaticArray<PlayerState, PLAYER_POOL_SIZE> states {};
+	StaticArray<int, PLAYER_POOL_SIZE> virtualWorlds {};
+	StaticArray<unsigned, PLAYER_POOL_SIZE> interiors {};
+	StaticArray<float, PLAYER_POOL_SIZE> healths {};
+	StaticArray<float, PLAYER_POOL_SIZE> armours {};
+
+	/// Copy the current state of every player in the pool
+	void refresh(IPlayerPool& pool, unsigned now)
+	{
+		tick = now;
+		present.fill(0);
+		for (IPlayer* player : pool.entries())
+		{
+			const int id = player->getID();
+			present[id] = 1;
+			positions[id] = player->getPosition();
+			velocities[id] = player->getVelocity();
+			states[id] = player->getState();
+			virtualWorlds[id] = player->getVirtualWorld();
+			interiors[id] = player->getInterior();
+			healths[id] = player->getHealth();
+			armours[id] = player->getArmour();
+		}
+	}
+
+	unsigned getSnapshotTick() const override
+	{
+		return tick;
+	}
+
+	Span<const uint8_t> isPresent() const override
+	{
+		return Span<const uint8_t>(present.data(), present.size());
+	}
+
+	Span<const Vector3> getPositions() const override
+	{
+		return Span<const Vector3>(positions.data(), positions.size());
+	}
+
+	Span<const Vector3> getVelocities() const override
+	{
+		return Span<const Vector3>(velocities.data(), velocities.size());
+	}
+
+	Span<const PlayerState> getStates() const override
+	{
+		return Span<const PlayerState>(states.data(), states.size());
+	}
+
+	Span<const int> getVirtualWorlds() const override
+	{
+		return Span<const int>(virtualWorlds.data(), virtualWorlds.size());
+	}
+
+	Span<const unsigned> getInteriors() const override
+	{
+		return Span<const unsigned>(interiors.data(), interiors.size());
+	}
+
+	Span<const float> getHealths() const override
+	{
+		return Span<const float>(healths.data(), healths.size());
+	}
+
+	Span<const float> getArmours() const override
+	{
+		return Span<const float>(armours.data(), armours.size());
+	}
+
+	void reset() override
+	{
+		present.fill(0);
+	}
+};
+
+}
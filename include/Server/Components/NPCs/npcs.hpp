@@ -12,6 +12,12 @@ enum NPCMoveType
 	NPCMoveType_Auto
 };
 
+enum NPCRouteNodeType
+{
+	NPCRouteNodeType_Vehicle,
+	NPCRouteNodeType_Ped
+};
+
 enum class EntityCheckType : uint8_t
 {
 	None = 0,
@@ -26,6 +32,18 @@ enum class EntityCheckType : uint8_t
 	All = 255
 };
 
+/// Per-NPC parameters for INPCComponent::createMany
+struct NPCCreateParams
+{
+	StringView name;
+	Vector3 position = Vector3(0.0f, 0.0f, 0.0f);
+	float angle = 0.0f;
+	int skin = 0;
+	int virtualWorld = 0;
+	unsigned int interior = 0;
+	bool spawn = true; ///< Whether to spawn the NPC right away
+};
+
 struct INPC : public IExtensible, public IIDProvider
 {
 	/// Get player instance of NPC.
@@ -418,6 +436,13 @@ struct NPCEventHandler
 	virtual void onNPCFinishMovePath(INPC& npc, int pathId) {};
 };
 
+/// Results of INPCComponent::findRoute, a separate handler so NPCEventHandler keeps its vtable
+struct NPCRouteEventHandler
+{
+	/// @param pathId The ID of the path holding the route, or INVALID_PATH_ID if there is no route
+	virtual void onNPCRouteFound(int requestId, int pathId) { }
+};
+
 static const UID NPCComponent_UID = UID(0x3D0E59E87F4E90BC);
 struct INPCComponent : public IPool<INPC>, public INetworkComponent
 {
@@ -459,6 +484,7 @@ struct INPCComponent : public IPool<INPC>, public INetworkComponent
 	/// Gets point information by the given point index in a path
 	virtual bool getPathPoint(int pathId, size_t pointIndex, Vector3& position, float& stopRange) = 0;
 
+	/// Check if any point of a path is within a radius of a position
 	virtual bool hasPathPointInRange(int pathId, const Vector3& position, float radius) = 0;
 
 	/// Check if a path id is valid
@@ -502,4 +528,57 @@ struct INPCComponent : public IPool<INPC>, public INetworkComponent
 
 	/// Get node information (vehicle nodes, pedestrian nodes, navigation nodes)
 	virtual bool getNodeInfo(int nodeId, uint32_t& vehicleNodes, uint32_t& pedNodes, uint32_t& naviNodes) = 0;
+
+	/// Set the number of worker threads used for the read-only phase of the NPC update
+	/// Target re-evaluation (moveToPlayer) and between-entity checks (aimAt, aimAtPlayer, shoot) are computed
+	/// on the workers, the results are then applied on the main thread in NPC ID order so NPCEventHandler
+	/// events are always dispatched from the main thread in a deterministic order
+	/// @param count The number of extra threads, 0 runs the whole update on the main thread
+	virtual void setUpdateWorkerCount(unsigned count) = 0;
+
+	/// Get the number of worker threads used for the read-only phase of the NPC update
+	virtual unsigned getUpdateWorkerCount() const = 0;
+
+	/// Find the point of a path closest to a position
+	/// Paths keep a spatial index which is rebuilt when their points change, so this doesn't scan every point
+	/// @param[out] pointIndex The index of the closest point
+	/// @param[out] distance The distance to the closest point
+	/// @return False if the path is invalid or empty
+	virtual bool getNearestPathPoint(int pathId, const Vector3& position, size_t& pointIndex, float& distance) = 0;
+
+	/// Load every node file into the node cache, after which openNode doesn't touch the disk
+	/// Nodes opened without this are cached on first open and stay cached after closeNode
+	/// @return The number of nodes in the cache
+	virtual int preloadNodes() = 0;
+
+	/// Queue an A* route search between two positions over the vehicle or ped points of the open nodes
+	/// The search runs on a worker thread, once it finishes the route is stored as a new path ready for
+	/// INPC::moveByPath and NPCRouteEventHandler::onNPCRouteFound is dispatched from the main thread with its ID,
+	/// or INVALID_PATH_ID if there is no route; routes between the same two node points are cached until a node is opened or closed
+	/// @return The ID of the search request, or -1 if no nodes are open
+	virtual int findRoute(const Vector3& from, const Vector3& to, NPCRouteNodeType type) = 0;
+
+	/// Cancel a queued route search, onNPCRouteFound won't be dispatched for it
+	/// @return False if the search has already finished or the ID is invalid
+	virtual bool cancelRouteSearch(int requestId) = 0;
+
+	/// Set how many routes are kept in the route cache, 0 disables caching
+	/// Shrinking the cache evicts the least recently used routes right away
+	virtual void setRouteCacheSize(size_t size) = 0;
+
+	/// Create several NPCs at once
+	/// Player pool slots for the whole batch are reserved up front, then every entry is set up before
+	/// onPoolEntryCreated, onNPCCreate and the connect events are dispatched for each NPC in a single pass;
+	/// the NPCs are streamed in to players in the next streaming update rather than one by one
+	/// @param[out] created Receives the created NPCs in the order of params, nullptr where creation failed
+	/// (such as a taken name or a full pool), must be at least as long as params
+	/// @return The number of NPCs created
+	virtual size_t createMany(Span<const NPCCreateParams> params, Span<INPC*> created) = 0;
+
+	/// Destroy several NPCs at once, dispatching the destroy and disconnect events in a single pass
+	/// Null entries are skipped
+	virtual void destroyMany(Span<INPC* const> npcs) = 0;
+
+	/// Get the dispatcher for route search results, see findRoute
+	virtual IEventDispatcher<NPCRouteEventHandler>& getRouteEventDispatcher() = 0;
 };
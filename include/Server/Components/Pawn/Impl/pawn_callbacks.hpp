@@ -0,0 +1,151 @@
+#pragma once
+
+#include <Server/Components/Pawn/pawn.hpp>
+#include <climits>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// Interns callback names into PawnCallback handles, backs IPawnComponent::registerCallback
+class PawnCallbackRegistry final : public NoCopy
+{
+public:
+	PawnCallback add(StringView name)
+	{
+		String key(name.data(), name.size());
+		auto it = ids_.find(key);
+		if (it != ids_.end())
+		{
+			return PawnCallback { it->second };
+		}
+		const int id = int(names_.size());
+		ids_.emplace(key, id);
+		names_.emplace_back(std::move(key));
+		return PawnCallback { id };
+	}
+
+	/// Get a registered callback's name, null terminated
+	const char* name(PawnCallback callback) const
+	{
+		return contains(callback) ? names_[callback.id].c_str() : nullptr;
+	}
+
+	bool contains(PawnCallback callback) const
+	{
+		return callback.id >= 0 && size_t(callback.id) < names_.size();
+	}
+
+	size_t size() const
+	{
+		return names_.size();
+	}
+
+private:
+	FlatHashMap<String, int> ids_;
+	DynamicArray<String> names_;
+};
+
+/// A script's public indices by callback, backs IPawnScript::FindCallback
+/// Indices are looked up on first use; clear the cache when the script is (re)loaded
+class PawnCallbackCache final : public NoCopy
+{
+public:
+	int find(IPawnScript& script, const PawnCallbackRegistry& registry, PawnCallback callback, int* index)
+	{
+		*index = INT_MAX;
+		if (!registry.contains(callback))
+		{
+			return AMX_ERR_NOTFOUND;
+		}
+		if (size_t(callback.id) >= indices_.size())
+		{
+			indices_.resize(registry.size(), Unresolved);
+		}
+		int& cached = indices_[callback.id];
+		if (cached == Unresolved)
+		{
+			int idx;
+			cached = script.FindPublic(registry.name(callback), &idx) == AMX_ERR_NONE ? idx : INT_MAX;
+		}
+		*index = cached;
+		return cached == INT_MAX ? AMX_ERR_NOTFOUND : AMX_ERR_NONE;
+	}
+
+	void clear()
+	{
+		indices_.clear();
+	}
+
+private:
+	static constexpr int Unresolved = -1;
+
+	DynamicArray<int> indices_;
+};
+
+/// The scripts exporting each registered callback, backs IPawnComponent::getCallbackSubscribers
+/// Call rebuild after a script is loaded and before an unloaded script is freed
+class PawnCallbackSubscribers final : public NoCopy
+{
+public:
+	Span<const PawnCallbackSubscriber> get(IPawnComponent& pawn, const PawnCallbackRegistry& registry, PawnCallback callback)
+	{
+		if (!registry.contains(callback))
+		{
+			return Span<const PawnCallbackSubscriber>();
+		}
+		if (size_t(callback.id) >= lists_.size())
+		{
+			lists_.resize(registry.size());
+		}
+		List& list = lists_[callback.id];
+		if (!list.built)
+		{
+			build(pawn, callback, list);
+		}
+		return Span<const PawnCallbackSubscriber>(list.subscribers.data(), list.subscribers.size());
+	}
+
+	/// Work out every list again for the current set of scripts
+	/// @param unloading A script that is being unloaded and must be left out, or nullptr
+	void rebuild(IPawnComponent& pawn, const PawnCallbackRegistry& registry, IPawnScript* unloading = nullptr)
+	{
+		lists_.resize(registry.size());
+		for (size_t id = 0; id != lists_.size(); ++id)
+		{
+			build(pawn, PawnCallback { int(id) }, lists_[id], unloading);
+		}
+	}
+
+private:
+	struct List
+	{
+		DynamicArray<PawnCallbackSubscriber> subscribers;
+		bool built = false;
+	};
+
+	static void add(IPawnScript* script, PawnCallback callback, List& list, IPawnScript* unloading)
+	{
+		int index;
+		if (script && script != unloading && script->FindCallback(callback, &index) == AMX_ERR_NONE)
+		{
+			list.subscribers.push_back(PawnCallbackSubscriber { script, index });
+		}
+	}
+
+	static void build(IPawnComponent& pawn, PawnCallback callback, List& list, IPawnScript* unloading = nullptr)
+	{
+		list.subscribers.clear();
+		for (IPawnScript* script : pawn.sideScripts())
+		{
+			add(script, callback, list, unloading);
+		}
+		add(pawn.mainScript(), callback, list, unloading);
+		list.built = true;
+	}
+
+	DynamicArray<List> lists_;
+};
+
+}
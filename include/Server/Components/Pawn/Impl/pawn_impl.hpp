@@ -47,9 +47,16 @@ void setAmxLookups(ICore* core)
 	lookups_.core = core;
 	lookups_.config = &core->getConfig();
 	lookups_.players = &core->getPlayers();
+	lookups_.playerCache.attach(*lookups_.players);
 	setAmxLookups();
 }
 
+/// Stop listening to the player pool, call from the component's onFree or free while the core is still alive
+void clearAmxLookups()
+{
+	lookups_.playerCache.detach();
+}
+
 PawnLookup* getAmxLookups()
 {
 	return &lookups_;
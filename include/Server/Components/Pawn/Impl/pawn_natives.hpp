@@ -12,10 +12,27 @@
 #include <pawn-natives/NativeFunc.hpp>
 
 #include <Server/Components/Pawn/pawn.hpp>
+#include <Server/Components/Pawn/Impl/pawn_strings.hpp>
 
 /// The bool is used because variant is initialised to index 0 by default
 using OutputOnlyString = std::variant<bool, StringView, Impl::String>;
 
+/// A string parameter read into per-thread scratch memory instead of an Impl::String
+/// Only valid until the native returns, copy it to keep it
+struct ScratchStringView : public StringView
+{
+	ScratchStringView() = default;
+
+	ScratchStringView(StringView view, Impl::PawnTextKind kind)
+		: StringView(view)
+		, kind(kind)
+	{
+	}
+
+	/// What the string contains, so callers can skip encoding conversions for plain ASCII
+	Impl::PawnTextKind kind = Impl::PawnTextKind_Ascii;
+};
+
 /// Macro to define a script param for a pool entry
 /// Example with IPlayer from the players pool:
 /// Using IPlayer& in a script function throws an exception if the player with the specified ID doesn't exist
@@ -35,6 +52,10 @@ using OutputOnlyString = std::variant<bool, StringView, Impl::String>;
 		}                                                   \
 	};                                                      \
                                                             \
+	POOL_PARAM_CASTS(type)
+
+/// The ParamCasts of POOL_PARAM, for pools with their own ParamLookup
+#define POOL_PARAM_CASTS(type)                              \
 	template <>                                             \
 	class ParamCast<type*>                                  \
 	{                                                       \
@@ -128,7 +149,7 @@ using OutputOnlyString = std::variant<bool, StringView, Impl::String>;
 				return nullptr;                                                                      \
 			}                                                                                        \
                                                                                                      \
-			auto data = queryExtension<dataType>(player);                                            \
+			auto data = getAmxLookups()->playerCache.data<dataType>(player);                         \
 			if (data)                                                                                \
 			{                                                                                        \
 				return data->get(ref);                                                               \
@@ -237,7 +258,7 @@ using OutputOnlyString = std::variant<bool, StringView, Impl::String>;
 			{                                                                        \
 				return nullptr;                                                      \
 			}                                                                        \
-			return queryExtension<type>(player);                                     \
+			return getAmxLookups()->playerCache.data<type>(player);                  \
 		}                                                                            \
 	};                                                                               \
                                                                                      \
@@ -432,7 +453,7 @@ using OutputOnlyString = std::variant<bool, StringView, Impl::String>;
 				return nullptr;                                                                      \
 			}                                                                                        \
                                                                                                      \
-			auto data = queryExtension<dataType>(player);                                            \
+			auto data = getAmxLookups()->playerCache.data<dataType>(player);                         \
 			auto pool = getAmxLookups()->poolPtr;                                                    \
 			if (pool && data)                                                                        \
 			{                                                                                        \
@@ -533,7 +554,17 @@ using OutputOnlyString = std::variant<bool, StringView, Impl::String>;
 namespace pawn_natives
 {
 
-POOL_PARAM(IPlayer, players);
+template <>
+struct ParamLookup<IPlayer>
+{
+	static IPlayer* Val(cell ref) noexcept
+	{
+		PawnLookup* lookups = getAmxLookups();
+		return lookups->playerCache.player(lookups->players, ref);
+	}
+};
+POOL_PARAM_CASTS(IPlayer);
+
 POOL_PARAM(IActor, actors);
 POOL_PARAM(IClass, classes);
 POOL_PARAM(IMenu, menus);
@@ -590,7 +621,7 @@ public:
 		if (addr_ && idx != 0 && idx != std::variant_npos)
 		{
 			StringView str = (idx == 1 ? std::get<StringView>(value_) : std::get<Impl::String>(value_));
-			amx_SetStringLen(addr_, str.data(), str.length(), 0, 0, len_);
+			Impl::PawnStrings::widen(str, addr_, len_);
 		}
 	}
 
@@ -1356,6 +1387,156 @@ private:
 	bool error_ = false;
 };
 
+/// Get the physical address of an array of cells in a script, checking that the whole array lies within the
+/// script's data and heap (below HEA) or its stack (from STK up to STP)
+/// @return nullptr if the array is out of bounds
+inline cell* GetArrayAddr(AMX* amx, cell addr, int len)
+{
+	if (len < 0 || addr < 0)
+	{
+		return nullptr;
+	}
+	const int64_t end = int64_t(addr) + int64_t(len) * int64_t(sizeof(cell));
+	if (end > amx->hea && (addr < amx->stk || end > amx->stp))
+	{
+		return nullptr;
+	}
+	cell* data = nullptr;
+	amx_GetAddr(amx, addr, &data);
+	return data;
+}
+
+/// Get the physical address of a string in a script and the number of cells that can be read from it before
+/// leaving the script's data and heap or its stack
+/// @return nullptr if the address is out of bounds
+inline cell* GetStringAddr(AMX* amx, cell addr, size_t& maxCells)
+{
+	if (addr >= 0 && addr < amx->hea)
+	{
+		maxCells = size_t(amx->hea - addr) / sizeof(cell);
+	}
+	else if (addr >= amx->stk && addr < amx->stp)
+	{
+		maxCells = size_t(amx->stp - addr) / sizeof(cell);
+	}
+	else
+	{
+		return nullptr;
+	}
+	cell* data = nullptr;
+	amx_GetAddr(amx, addr, &data);
+	return data;
+}
+
+/// A view of an array parameter directly in AMX memory, without copying it like DynamicArray params do
+/// Writes through Span<cell> go straight to the script; use amx_ctof/amx_ftoc for Float: arrays
+template <typename T>
+class ParamCast<Span<T>>
+{
+	static_assert(std::is_same_v<std::remove_const_t<T>, cell>, "Only arrays of cells can be viewed in place, use DynamicArray for other types");
+
+public:
+	ParamCast(AMX* amx, cell* params, int idx)
+		: value_()
+	{
+		const int len = (int)params[idx + 1];
+		cell* data = GetArrayAddr(amx, params[idx + 0], len);
+		if (data == nullptr)
+		{
+			error_ = len != 0;
+		}
+		else
+		{
+			value_ = Span<T>(data, len);
+		}
+	}
+
+	~ParamCast()
+	{
+	}
+
+	ParamCast(ParamCast<Span<T>> const&) = delete;
+	ParamCast(ParamCast<Span<T>>&&) = delete;
+
+	operator Span<T>()
+	{
+		return value_;
+	}
+
+	bool Error() const
+	{
+		return error_;
+	}
+
+	static constexpr int Size = 2;
+
+private:
+	Span<T> value_;
+	bool error_ = false;
+};
+
+/// Reads a string parameter into scratch memory, only allocating when the scratch memory is used up
+template <>
+class ParamCast<ScratchStringView>
+{
+public:
+	ParamCast(AMX* amx, cell* params, int idx)
+	{
+		size_t maxCells = 0;
+		const cell* source = GetStringAddr(amx, params[idx], maxCells);
+		if (source == nullptr)
+		{
+			error_ = true;
+			return;
+		}
+		Impl::PawnTextKind kind;
+		size_t len = Impl::PawnStrings::narrow(source, maxCells, scratch_.data(), scratch_.capacity(), kind);
+		if (len <= scratch_.capacity())
+		{
+			scratch_.commit(len);
+			value_ = ScratchStringView(StringView(scratch_.data(), len), kind);
+		}
+		else
+		{
+			fallback_.resize(len);
+			Impl::PawnStrings::narrow(source, maxCells, fallback_.data(), len, kind);
+			value_ = ScratchStringView(StringView(fallback_.data(), len), kind);
+		}
+	}
+
+	~ParamCast()
+	{
+	}
+
+	ParamCast(ParamCast<ScratchStringView> const&) = delete;
+	ParamCast(ParamCast<ScratchStringView>&&) = delete;
+
+	operator ScratchStringView()
+	{
+		return value_;
+	}
+
+	bool Error() const
+	{
+		return error_;
+	}
+
+	static constexpr int Size = 1;
+
+private:
+	Impl::PawnStringScratch scratch_;
+	Impl::String fallback_;
+	ScratchStringView value_;
+	bool error_ = false;
+};
+
+template <>
+class ParamCast<ScratchStringView const&> : public ParamCast<ScratchStringView>
+{
+public:
+	using ParamCast<ScratchStringView>::ParamCast;
+};
+
 class NotImplemented : public std::logic_error
 {
 public:
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <types.hpp>
+#include <amx/amx.h>
+#include <algorithm>
+
+#if PAWN_CELL_SIZE == 32 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define OMP_PAWN_STRINGS_SSE2
+#include <emmintrin.h>
+#endif
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// What a string read from a script turned out to contain
+enum PawnTextKind
+{
+	PawnTextKind_Ascii, ///< Only 7-bit characters
+	PawnTextKind_UTF8, ///< Valid UTF-8 with at least one multi-byte sequence
+	PawnTextKind_Other ///< Anything else, usually text in a legacy code page
+};
+
+namespace PawnStrings
+{
+	/// Narrows characters one at a time while checking whether they form valid UTF-8
+	class ByteSink
+	{
+	public:
+		ByteSink(char* dest, size_t destSize)
+			: dest_(dest)
+			, destSize_(destSize)
+		{
+		}
+
+		void put(size_t pos, ucell c)
+		{
+			// Packed-as-unpacked strings built from signed chars hold bytes 0x80-0xFF sign-extended to [-128, -1]
+			if (c >= ucell(-128))
+			{
+				c &= 0xFF;
+			}
+			if (pos < destSize_)
+			{
+				dest_[pos] = char(c);
+			}
+			if (c < 0x80)
+			{
+				if (need_)
+				{
+					kind_ = PawnTextKind_Other;
+				}
+				return;
+			}
+			if (kind_ == PawnTextKind_Other)
+			{
+				return;
+			}
+			if (c > 0xFF)
+			{
+				kind_ = PawnTextKind_Other;
+				return;
+			}
+			kind_ = PawnTextKind_UTF8;
+			if (need_)
+			{
+				if (c < lo_ || c > hi_)
+				{
+					kind_ = PawnTextKind_Other;
+				}
+				lo_ = 0x80;
+				hi_ = 0xBF;
+				--need_;
+				return;
+			}
+			lo_ = 0x80;
+			hi_ = 0xBF;
+			if (c >= 0xC2 && c <= 0xDF)
+			{
+				need_ = 1;
+			}
+			else if (c >= 0xE0 && c <= 0xEF)
+			{
+				need_ = 2;
+				// No overlong encodings or surrogates
+				if (c == 0xE0)
+				{
+					lo_ = 0xA0;
+				}
+				else if (c == 0xED)
+				{
+					hi_ = 0x9F;
+				}
+			}
+			else if (c >= 0xF0 && c <= 0xF4)
+			{
+				need_ = 3;
+				// No overlong encodings or code points past U+10FFFF
+				if (c == 0xF0)
+				{
+					lo_ = 0x90;
+				}
+				else if (c == 0xF4)
+				{
+					hi_ = 0x8F;
+				}
+			}
+			else
+			{
+				kind_ = PawnTextKind_Other;
+			}
+		}
+
+		PawnTextKind finish() const
+		{
+			return need_ ? PawnTextKind_Other : kind_;
+		}
+
+	private:
+		char* dest_;
+		size_t destSize_;
+		PawnTextKind kind_ = PawnTextKind_Ascii;
+		unsigned need_ = 0;
+		ucell lo_ = 0x80;
+		ucell hi_ = 0xBF;
+	};
+
+	/// Check whether a string is packed, the same way the AMX does
+	inline bool isPacked(const cell* source, size_t maxCells)
+	{
+		constexpr ucell UnpackedMax = (ucell(1) << ((sizeof(cell) - 1) * 8)) - 1;
+		return maxCells && ucell(*source) > UnpackedMax;
+	}
+
+	/// Narrow a string from a script into chars, packed strings are unpacked first
+	/// Characters are truncated to their low byte like amx_GetString does, the whole string is classified along
+	/// the way, and runs of ASCII characters in unpacked strings are narrowed 16 at a time
+	/// @param source The string in AMX memory
+	/// @param maxCells The number of cells that can be read at source, a string without a terminator ends there
+	/// @param dest Where to write the chars, no terminator is added
+	/// @param destSize The capacity of dest
+	/// @param[out] kind What the string contains
+	/// @return The length of the string, which is more than destSize if it didn't fit
+	inline size_t narrow(const cell* source, size_t maxCells, char* dest, size_t destSize, PawnTextKind& kind)
+	{
+		ByteSink sink(dest, destSize);
+		size_t len = 0;
+		if (isPacked(source, maxCells))
+		{
+			for (size_t i = 0; i != maxCells; ++i)
+			{
+				const ucell packed = ucell(source[i]);
+				for (int shift = (sizeof(cell) - 1) * 8; shift >= 0; shift -= 8)
+				{
+					const ucell c = (packed >> shift) & 0xFF;
+					if (c == 0)
+					{
+						kind = sink.finish();
+						return len;
+					}
+					sink.put(len++, c);
+				}
+			}
+			kind = sink.finish();
+			return len;
+		}
+
+#if defined(OMP_PAWN_STRINGS_SSE2)
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i high = _mm_set1_epi32(~0x7F);
+		while (len + 16 <= maxCells && len + 16 <= destSize)
+		{
+			const __m128i* block = reinterpret_cast<const __m128i*>(source + len);
+			const __m128i a = _mm_loadu_si128(block);
+			const __m128i b = _mm_loadu_si128(block + 1);
+			const __m128i c = _mm_loadu_si128(block + 2);
+			const __m128i d = _mm_loadu_si128(block + 3);
+			const __m128i ends = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(a, zero), _mm_cmpeq_epi32(b, zero)), _mm_or_si128(_mm_cmpeq_epi32(c, zero), _mm_cmpeq_epi32(d, zero)));
+			const __m128i wide = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), high);
+			if (_mm_movemask_epi8(_mm_or_si128(ends, _mm_cmpeq_epi32(_mm_cmpeq_epi32(wide, zero), zero))))
+			{
+				// The terminator or a non-ASCII character, finish one at a time
+				break;
+			}
+			// Every cell is 1 to 127 so neither pack saturates
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + len), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+			len += 16;
+		}
+#endif
+
+		for (; len != maxCells && source[len] != 0; ++len)
+		{
+			sink.put(len, ucell(source[len]));
+		}
+		kind = sink.finish();
+		return len;
+	}
+
+	/// Widen chars into an unpacked, null terminated string in a script, 16 at a time where possible
+	/// By default chars are sign extended like amx_SetString does, so bytes past 127 (text in a code page like
+	/// cp1251) are negative in the script just as they always were
+	/// @param destCells The capacity of dest including the terminator, the string is cut off to fit
+	/// @param zeroExtend Keep bytes past 127 positive instead, only for scripts that expect it
+	/// @return The number of characters written, not counting the terminator
+	inline size_t widen(StringView source, cell* dest, size_t destCells, bool zeroExtend = false)
+	{
+		if (destCells == 0)
+		{
+			return 0;
+		}
+		const size_t len = std::min(source.size(), destCells - 1);
+		size_t i = 0;
+#if defined(OMP_PAWN_STRINGS_SSE2)
+		const __m128i zero = _mm_setzero_si128();
+		for (; i + 16 <= len; i += 16)
+		{
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source.data() + i));
+			// Unpacking with the sign bits of each lane sign extends it, unpacking with zero zero extends it
+			const __m128i byteSigns = zeroExtend ? zero : _mm_cmpgt_epi8(zero, bytes);
+			const __m128i lo = _mm_unpacklo_epi8(bytes, byteSigns);
+			const __m128i hi = _mm_unpackhi_epi8(bytes, byteSigns);
+			const __m128i loSigns = _mm_srai_epi16(lo, 15);
+			const __m128i hiSigns = _mm_srai_epi16(hi, 15);
+			__m128i* out = reinterpret_cast<__m128i*>(dest + i);
+			_mm_storeu_si128(out, _mm_unpacklo_epi16(lo, loSigns));
+			_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, loSigns));
+			_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, hiSigns));
+			_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, hiSigns));
+		}
+#endif
+		if (zeroExtend)
+		{
+			for (; i != len; ++i)
+			{
+				dest[i] = cell(static_cast<unsigned char>(source[i]));
+			}
+		}
+		else
+		{
+			for (; i != len; ++i)
+			{
+				dest[i] = cell(static_cast<signed char>(source[i]));
+			}
+		}
+		dest[len] = 0;
+		return len;
+	}
+}
+
+/// Per-thread scratch memory for strings read from scripts
+/// Taken and given back in stack order as native params are constructed and destroyed, so a native that calls
+/// back into a script doesn't clobber the strings of the native that called it
+class PawnStringScratch final : public NoCopy
+{
+public:
+	static constexpr size_t ArenaSize = 65536;
+
+	PawnStringScratch()
+		: start_(arena().used)
+	{
+	}
+
+	~PawnStringScratch()
+	{
+		arena().used = start_;
+	}
+
+	char* data()
+	{
+		return arena().data.data() + start_;
+	}
+
+	size_t capacity() const
+	{
+		return ArenaSize - start_;
+	}
+
+	/// Keep the first size bytes until this is destroyed
+	void commit(size_t size)
+	{
+		arena().used = start_ + std::min(size, capacity());
+	}
+
+private:
+	struct Arena
+	{
+		StaticArray<char, ArenaSize> data;
+		size_t used = 0;
+	};
+
+	static Arena& arena()
+	{
+		static thread_local Arena instance;
+		return instance;
+	}
+
+	size_t start_;
+};
+
+}
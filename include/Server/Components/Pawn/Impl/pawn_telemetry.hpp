@@ -0,0 +1,176 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <Server/Components/Pawn/pawn.hpp>
+#include <algorithm>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// A script's heap and stack telemetry, backs IPawnMemoryTelemetry
+/// Meant to be driven from the script's own Exec, Allot and Release, which see every public call and heap change
+class PawnMemoryTracker final : public NoCopy
+{
+public:
+	/// Take a look at the heap and stack, update the high water marks
+	void sample(IPawnScript& script)
+	{
+		if (stats_.heapStackSize == 0)
+		{
+			long code, data;
+			script.MemInfo(&code, &data, &stats_.heapStackSize);
+		}
+		stats_.heapUsed = script.GetHEA() - script.GetHLW();
+		stats_.stackUsed = script.GetSTP() - script.GetSTK();
+		stats_.heapHighWater = std::max(stats_.heapHighWater, stats_.heapUsed);
+		stats_.stackHighWater = std::max(stats_.stackHighWater, stats_.stackUsed);
+	}
+
+	/// Record a public call, with the heap right before and right after Exec
+	/// @param logger Where to warn about leaks, only the first leak of each public is logged so a leaking callback
+	/// like OnPlayerUpdate can't flood the log; nullptr to not warn
+	/// @return False if the public returned with more heap allocated than it started with
+	bool onExec(IPawnScript& script, int index, cell heaBefore, cell heaAfter, ILogger* logger = nullptr)
+	{
+		sample(script);
+		Callback& callback = callbacks_[index];
+		const cell delta = heaAfter - heaBefore;
+		++callback.calls;
+		callback.maxDelta = std::max(callback.maxDelta, delta);
+		if (delta > 0)
+		{
+			++callback.leaks;
+			if (logger && !callback.warned)
+			{
+				callback.warned = true;
+				char name[64] = "";
+				script.GetPublic(index, name);
+				logger->logLn(LogLevel::Warning, "Script %d: public %s returned with %d more bytes of heap allocated, further leaks from it are only counted", script.GetID(), name, int(delta));
+			}
+			return false;
+		}
+		return true;
+	}
+
+	/// Record heap allocated with Allot, call after every successful Allot
+	/// Allots are tracked by depth, as a native calling back into the script (CallChecked and the like) allots and
+	/// releases inside its caller's allocation; the heap is snapshotted before the outermost one, which is where it
+	/// should be back to when the matching Release returns
+	void onAllot(IPawnScript& script, int cells)
+	{
+		const cell heaBefore = script.GetHEA() - cell(cells * sizeof(cell));
+		// The heap dropping back to the snapshot means the outer allocation was freed without Release, such as by
+		// a public returning, so start over rather than never checking again
+		if (allotDepth_ == 0 || heaBefore <= allotBase_)
+		{
+			allotDepth_ = 0;
+			allotBase_ = heaBefore;
+		}
+		++allotDepth_;
+		allotted_ += cells;
+		sample(script);
+	}
+
+	/// Check the heap after Release, only once the outermost Allot is released
+	/// Release only ever lowers the heap to the address it's given, so checking against that address can't find
+	/// anything; what leaks is heap taken by an Allot before the one being released, which stays allocated
+	/// @param logger Where to warn about leaks, only the first one is logged; nullptr to not warn
+	/// @return False if the heap is still above where it was before the outermost Allot, which is counted as a leak
+	bool onRelease(IPawnScript& script, ILogger* logger = nullptr)
+	{
+		if (allotDepth_ == 0 || --allotDepth_ != 0)
+		{
+			return true;
+		}
+		const cell hea = script.GetHEA();
+		if (hea > allotBase_)
+		{
+			++stats_.leaks;
+			if (logger && !releaseWarned_)
+			{
+				releaseWarned_ = true;
+				logger->logLn(LogLevel::Warning, "Script %d: Release left %d bytes of heap allocated, further leaks are only counted", script.GetID(), int(hea - allotBase_));
+			}
+			return false;
+		}
+		return true;
+	}
+
+	/// Update the allocation rate, call once per tick
+	void tick(TimePoint now)
+	{
+		const float elapsed = std::chrono::duration<float>(now - rateStart_).count();
+		if (elapsed >= 1.0f)
+		{
+			stats_.allotRate = rateStart_ == TimePoint() ? 0.0f : allotted_ / elapsed;
+			allotted_ = 0;
+			rateStart_ = now;
+		}
+	}
+
+	const PawnMemoryStats& stats() const
+	{
+		return stats_;
+	}
+
+	/// Fill in per-public heap usage, the publics leaving the most heap allocated first
+	/// @return The number of publics called so far
+	size_t getCallbackHeapStats(Span<PawnCallbackHeapStats> output) const
+	{
+		if (!output.empty())
+		{
+			DynamicArray<PawnCallbackHeapStats> sorted;
+			sorted.reserve(callbacks_.size());
+			for (const auto& entry : callbacks_)
+			{
+				sorted.push_back(PawnCallbackHeapStats { entry.first, entry.second.calls, entry.second.maxDelta, entry.second.leaks });
+			}
+			const size_t count = std::min(output.size(), sorted.size());
+			std::partial_sort(sorted.begin(), sorted.begin() + count, sorted.end(), [](const PawnCallbackHeapStats& a, const PawnCallbackHeapStats& b)
+				{
+					return a.maxDelta > b.maxDelta;
+				});
+			std::copy(sorted.begin(), sorted.begin() + count, output.begin());
+		}
+		return callbacks_.size();
+	}
+
+	void reset()
+	{
+		stats_ = PawnMemoryStats {};
+		callbacks_.clear();
+		allotted_ = 0;
+		rateStart_ = TimePoint();
+		allotBase_ = 0;
+		allotDepth_ = 0;
+		releaseWarned_ = false;
+	}
+
+private:
+	struct Callback
+	{
+		uint64_t calls = 0;
+		cell maxDelta = 0;
+		uint64_t leaks = 0;
+		bool warned = false;
+	};
+
+	PawnMemoryStats stats_ {};
+	FlatHashMap<int, Callback> callbacks_;
+	uint64_t allotted_ = 0;
+	TimePoint rateStart_;
+	cell allotBase_ = 0;
+	unsigned allotDepth_ = 0;
+	bool releaseWarned_ = false;
+};
+
+}
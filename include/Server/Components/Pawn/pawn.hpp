@@ -1,7 +1,9 @@
 #pragma once
 
 #include <core.hpp>
+#include <Impl/Utils/extension_cache.hpp>
 #include <amx/amx.h>
+#include <algorithm>
 #include <array>
 #include <string>
 #include <vector>
@@ -42,6 +44,90 @@ enum DefaultReturnValue
 	DefaultReturnValue_True
 };
 
+namespace Impl
+{
+/// Players and their data extensions by ID, so native params resolve with an array load instead of a pool lookup
+/// and an extension query; entries are filled on first use and dropped by the player pool's destroy event
+/// Detach it from the component's onFree or free (see clearAmxLookups), it lives in static storage and is destroyed
+/// after the core has freed the player pool, so it can't detach itself
+class PawnPlayerCache final : public PoolEventHandler<IPlayer>, public NoCopy
+{
+public:
+	/// Start listening to a player pool
+	void attach(IPlayerPool& pool)
+	{
+		detach();
+		pool_ = &pool;
+		pool_->getPoolEventDispatcher().addEventHandler(this);
+		data_.attach(pool.getPoolEventDispatcher());
+	}
+
+	void detach()
+	{
+		data_.detach();
+		if (pool_)
+		{
+			pool_->getPoolEventDispatcher().removeEventHandler(this);
+			pool_ = nullptr;
+		}
+		clear();
+	}
+
+	/// Get the player with an ID, falls back to the pool while not attached
+	IPlayer* player(IPlayerPool* pool, cell id)
+	{
+		if (pool_ == nullptr || pool_ != pool)
+		{
+			return pool ? pool->get(id) : nullptr;
+		}
+		if (id < 0 || id >= PLAYER_POOL_SIZE)
+		{
+			return nullptr;
+		}
+		IPlayer*& cached = players_[id];
+		if (cached == nullptr)
+		{
+			cached = pool->get(id);
+		}
+		return cached;
+	}
+
+	/// Get a player's data extension
+	template <typename T>
+	T* data(IPlayer* player)
+	{
+		return data_.template query<T>(player);
+	}
+
+	/// Forget a player's cached data extension, call before removing it with removeExtension
+	template <typename T>
+	void forget(IPlayer& player)
+	{
+		data_.template forget<T>(player);
+	}
+
+	void clear()
+	{
+		players_.fill(nullptr);
+		data_.clear();
+	}
+
+	void onPoolEntryDestroyed(IPlayer& player) override
+	{
+		const int id = player.getID();
+		if (id >= 0 && id < PLAYER_POOL_SIZE)
+		{
+			players_[id] = nullptr;
+		}
+	}
+
+private:
+	IPlayerPool* pool_ = nullptr;
+	StaticArray<IPlayer*, PLAYER_POOL_SIZE> players_ {};
+	ExtensionCache<IPlayer, PLAYER_POOL_SIZE> data_;
+};
+}
+
 struct PawnLookup
 {
 	ICore* core = nullptr;
@@ -66,6 +152,7 @@ struct PawnLookup
 	IVehiclesComponent* vehicles = nullptr;
 	ICustomModelsComponent* models = nullptr;
 	INPCComponent* npcs = nullptr;
+	Impl::PawnPlayerCache playerCache;
 };
 
 PawnLookup* getAmxLookups();
@@ -322,6 +409,26 @@ struct NativeParam
 
 } // namespace Impl
 
+/// A callback name registered with IPawnComponent::registerCallback, for calling the same public repeatedly
+/// without a FindPublic string search every time
+struct PawnCallback
+{
+	int id = -1;
+
+	bool valid() const { return id >= 0; }
+	bool operator==(PawnCallback other) const { return id == other.id; }
+	bool operator!=(PawnCallback other) const { return id != other.id; }
+};
+
+struct IPawnScript;
+
+/// A script that exports a registered callback, with the callback's public index in it
+struct PawnCallbackSubscriber
+{
+	IPawnScript* script;
+	int index;
+};
+
 struct IPawnScript
 {
 	// Wrap the AMX API.
@@ -410,6 +517,14 @@ struct IPawnScript
 	/// @return The cell value returned by the native (use amx_ctof for float returns)
 	virtual cell CallNativeArray(const char* name, Span<Impl::NativeParam> params) = 0;
 
+	/// Find the index of a registered callback's public, cached per script until it is reloaded
+	/// @return AMX_ERR_NONE if the script has the public, AMX_ERR_NOTFOUND otherwise with index set to INT_MAX
+	virtual int FindCallback(PawnCallback callback, int* index) = 0;
+
+	/// Call a native by its index in this script, as returned by FindNative
+	/// @see CallNativeArray
+	virtual cell CallNativeArrayByIndex(int index, Span<Impl::NativeParam> params) = 0;
+
 	/// Templated wrapper around CallNativeArray for convenient SDK usage, with return type.
 	/// Automatically converts variadic arguments to NativeParam array.
 	/// @param name The name of the native function to call
@@ -418,19 +533,37 @@ struct IPawnScript
 	template <typename RET = cell, typename... Args>
 	RET CallNative(const char* name, Args&&... args)
 	{
-		cell result = 0;
 		if constexpr (sizeof...(args) == 0)
 		{
-			result = CallNativeArray(name, Span<Impl::NativeParam>());
+			return ConvertNativeReturn<RET>(CallNativeArray(name, Span<Impl::NativeParam>()));
 		}
 		else
 		{
-			Impl::DynamicArray<Impl::NativeParam> params;
-			params.reserve(sizeof...(args));
-			(params.push_back(Impl::NativeParam(std::forward<Args>(args))), ...);
-			result = CallNativeArray(name, Span<Impl::NativeParam>(params.data(), params.size()));
+			StaticArray<Impl::NativeParam, sizeof...(Args)> params = { Impl::NativeParam(std::forward<Args>(args))... };
+			return ConvertNativeReturn<RET>(CallNativeArray(name, Span<Impl::NativeParam>(params.data(), params.size())));
 		}
+	}
+
+	/// Same as CallNative by name, but with a native index already resolved through FindNative, so calls in a loop
+	/// skip the name lookup
+	/// @param index The index of the native in this script, from FindNative
+	template <typename RET = cell, typename... Args>
+	RET CallNative(int index, Args&&... args)
+	{
+		if constexpr (sizeof...(args) == 0)
+		{
+			return ConvertNativeReturn<RET>(CallNativeArrayByIndex(index, Span<Impl::NativeParam>()));
+		}
+		else
+		{
+			StaticArray<Impl::NativeParam, sizeof...(Args)> params = { Impl::NativeParam(std::forward<Args>(args))... };
+			return ConvertNativeReturn<RET>(CallNativeArrayByIndex(index, Span<Impl::NativeParam>(params.data(), params.size())));
+		}
+	}
 
+	template <typename RET>
+	static RET ConvertNativeReturn(cell result)
+	{
 		if constexpr (std::is_same_v<RET, float>)
 		{
 			return amx_ctof(result);
@@ -481,6 +614,18 @@ struct IPawnScript
 		return Call(name.c_str(), defaultRetValue, args...);
 	}
 
+	template <typename... T>
+	cell Call(PawnCallback callback, DefaultReturnValue defaultRetValue, T... args)
+	{
+		int idx;
+		cell ret = defaultRetValue;
+		if (!FindCallback(callback, &idx))
+		{
+			Call(ret, idx, args...);
+		}
+		return ret;
+	}
+
 	// Call a function using an idx we know is correct.
 	template <typename... T>
 	int CallChecked(int idx, cell& ret, T... args)
@@ -585,4 +730,90 @@ struct IPawnComponent : public IComponent
 	/// Get a set of all the available scripts.
 	virtual IPawnScript* mainScript() = 0;
 	virtual const Span<IPawnScript*> sideScripts() = 0;
+
+	/// Register a callback name once and get a handle that stays valid for the lifetime of the server
+	/// Registering the same name again returns the same handle
+	virtual PawnCallback registerCallback(StringView name) = 0;
+
+	/// Get the scripts exporting a registered callback, side scripts in load order then the main script
+	/// The list is worked out when scripts are loaded, so scripts without the public cost nothing when it's called.
+	/// It's only valid until a script is loaded or unloaded
+	virtual Span<const PawnCallbackSubscriber> getCallbackSubscribers(PawnCallback callback) = 0;
+
+	/// Call a registered callback in every script exporting it, in the order of getCallbackSubscribers
+	/// The subscribers are copied first, as a callback loading or unloading a script rebuilds the list; scripts
+	/// loaded during the call aren't called until the next one
+	/// @param breakOn Stop at the first script returning this value
+	/// @return The last script's return value, or defaultRetValue if no script exports the callback
+	template <typename... T>
+	cell callSubscribers(PawnCallback callback, DefaultReturnValue defaultRetValue, cell breakOn, T... args)
+	{
+		const Span<const PawnCallbackSubscriber> subscribers = getCallbackSubscribers(callback);
+		// Most callbacks have a few subscribers, so only long lists need a heap copy
+		StaticArray<PawnCallbackSubscriber, 16> local;
+		Impl::DynamicArray<PawnCallbackSubscriber> spilled;
+		Span<const PawnCallbackSubscriber> copy;
+		if (subscribers.size() <= local.size())
+		{
+			std::copy(subscribers.begin(), subscribers.end(), local.begin());
+			copy = Span<const PawnCallbackSubscriber>(local.data(), subscribers.size());
+		}
+		else
+		{
+			spilled.assign(subscribers.begin(), subscribers.end());
+			copy = Span<const PawnCallbackSubscriber>(spilled.data(), spilled.size());
+		}
+
+		cell ret = defaultRetValue;
+		for (const PawnCallbackSubscriber& subscriber : copy)
+		{
+			ret = defaultRetValue;
+			subscriber.script->Call(ret, subscriber.index, args...);
+			if (ret == breakOn)
+			{
+				break;
+			}
+		}
+		return ret;
+	}
+};
+
+/// A script's heap and stack usage, see IPawnMemoryTelemetry
+struct PawnMemoryStats
+{
+	long heapStackSize; ///< The size of the area shared by the heap and the stack, in bytes
+	cell heapUsed; ///< Bytes of heap in use when last sampled
+	cell heapHighWater; ///< The most heap seen in use
+	cell stackUsed; ///< Bytes of stack in use when last sampled
+	cell stackHighWater; ///< The most stack seen in use
+	float allotRate; ///< Cells allocated with Allot per second, over the last second
+	uint64_t leaks; ///< The number of times the heap stayed above where it was before the outermost Allot once its Release returned
+};
+
+/// How much heap a public left allocated, see IPawnMemoryTelemetry
+struct PawnCallbackHeapStats
+{
+	int index; ///< The index of the public in the script
+	uint64_t calls; ///< The number of calls
+	cell maxDelta; ///< The most heap a call left allocated when it returned, in bytes
+	uint64_t leaks; ///< The number of calls that returned with more heap allocated than they started with
+};
+
+/// Heap and stack usage of loaded scripts, queried from IPawnComponent
+/// Heap is sampled around every public call; a public returning with more heap than it started with, or the heap
+/// staying above where it was before the outermost Allot once its Release returns, is counted as a leak and logged as a warning the
+/// first time it happens for each public, or for each script in the case of Release
+static const UID PawnMemoryTelemetry_UID = UID(0x37a2f27b54162187);
+struct IPawnMemoryTelemetry : public IExtension
+{
+	PROVIDE_EXT_UID(PawnMemoryTelemetry_UID);
+
+	/// Get a script's memory usage
+	/// @return False if there's no loaded script with the ID
+	virtual bool getMemoryStats(int scriptID, PawnMemoryStats& stats) const = 0;
+
+	/// Get the heap usage of a script's publics, the ones leaving the most heap allocated first
+	/// @param[out] output Receives up to output.size() entries
+	/// @return The number of publics called so far, which may be more than what fit in output
+	virtual size_t getCallbackHeapStats(int scriptID, Span<PawnCallbackHeapStats> output) const = 0;
 };
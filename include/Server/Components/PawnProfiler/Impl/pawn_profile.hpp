@@ -0,0 +1,349 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <Server/Components/Pawn/pawn.hpp>
+#include <Server/Components/PawnProfiler/pawnprofiler.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// Walk a running script's call stack, innermost first: the current CIP, then the return address of every frame
+/// A frame holds the caller's FRM followed by the return address, and amx_Exec pushes 0 as the return address of
+/// the public it starts, which ends the walk
+/// @return The number of addresses written to output
+inline size_t walkPawnStack(IPawnScript& script, Span<cell> output)
+{
+	if (output.empty())
+	{
+		return 0;
+	}
+	size_t count = 0;
+	output[count++] = script.GetCIP();
+	const cell stk = script.GetSTK();
+	const cell stp = script.GetSTP();
+	cell frm = script.GetFRM();
+	while (count < output.size() && frm >= stk && frm <= stp - cell(2 * sizeof(cell)))
+	{
+		cell* frame = nullptr;
+		if (script.GetAddr(frm, &frame) != AMX_ERR_NONE || frame == nullptr || frame[1] == 0)
+		{
+			break;
+		}
+		output[count++] = frame[1];
+		// The stack grows down, so callers' frames are always above; anything else is a corrupt stack
+		if (frame[0] <= frm)
+		{
+			break;
+		}
+		frm = frame[0];
+	}
+	return count;
+}
+
+/// Raises a flag at a fixed interval from a background thread
+/// The debug hook and native callback check it with a single load and only walk the stack when it's set, so
+/// scripts are only ever read from the thread running them; the flag is only meaningful while a script runs, see
+/// onExecStart
+class PawnSampleClock final : public NoCopy
+{
+public:
+	~PawnSampleClock()
+	{
+		stop();
+	}
+
+	void start(Microseconds interval)
+	{
+		stop();
+		running_ = true;
+		thread_ = std::thread([this, interval]()
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				while (!wake_.wait_for(lock, interval, [this]
+					{
+						return !running_;
+					}))
+				{
+					due_.store(true, std::memory_order_relaxed);
+				}
+			});
+	}
+
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			running_ = false;
+		}
+		wake_.notify_all();
+		if (thread_.joinable())
+		{
+			thread_.join();
+		}
+		due_.store(false, std::memory_order_relaxed);
+	}
+
+	bool running() const
+	{
+		return thread_.joinable();
+	}
+
+	/// Drop a sample raised while no script was running, call when the server starts executing a public from
+	/// outside any script (not for nested calls such as CallRemoteFunction)
+	/// A stale flag would otherwise be consumed on the first instruction of the next callback, biasing samples
+	/// towards callback entry whenever the server is idle
+	void onExecStart()
+	{
+		due_.store(false, std::memory_order_relaxed);
+	}
+
+	/// Check whether a sample is due and clear the flag if so
+	bool consume()
+	{
+		return due_.load(std::memory_order_relaxed) && due_.exchange(false, std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<bool> due_ { false };
+	bool running_ = false;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::thread thread_;
+};
+
+/// How often and how long each native was called from one script
+/// Indexed by native, so recording a call is an array update; the profile merges every script's counters only
+/// when statistics are read
+class PawnNativeCounters final : public NoCopy
+{
+public:
+	void add(cell native, Nanoseconds time)
+	{
+		if (native < 0)
+		{
+			return;
+		}
+		if (size_t(native) >= entries_.size())
+		{
+			entries_.resize(size_t(native) + 1);
+		}
+		Entry& entry = entries_[native];
+		++entry.calls;
+		entry.time += time;
+	}
+
+	uint64_t calls(cell native) const
+	{
+		return size_t(native) < entries_.size() ? entries_[native].calls : 0;
+	}
+
+	Nanoseconds time(cell native) const
+	{
+		return size_t(native) < entries_.size() ? entries_[native].time : Nanoseconds(0);
+	}
+
+	size_t size() const
+	{
+		return entries_.size();
+	}
+
+	/// Zero every counter, the storage is kept
+	void clear()
+	{
+		std::fill(entries_.begin(), entries_.end(), Entry {});
+	}
+
+private:
+	struct Entry
+	{
+		uint64_t calls = 0;
+		Nanoseconds time { 0 };
+	};
+
+	DynamicArray<Entry> entries_;
+};
+
+/// Sampled stacks and native call statistics, backs IPawnProfilerComponent
+/// Names are only resolved when writing, by callbacks that know the scripts' debug information
+class PawnProfile final : public NoCopy
+{
+public:
+	static constexpr size_t MaxDepth = 128;
+
+	/// Record a sampled stack
+	/// @param stack Code addresses, innermost first, as returned by walkPawnStack
+	/// @param native The index of the native running when the sample was taken, or -1
+	void addSample(int scriptID, Span<const cell> stack, cell native = -1)
+	{
+		key_.clear();
+		append(scriptID);
+		append(native);
+		for (size_t i = stack.size(); i--;)
+		{
+			append(stack[i]);
+		}
+		++stacks_[key_];
+		++samples_;
+	}
+
+	/// Get the native counters of a script, look them up once when the script is loaded and keep the reference
+	/// It stays valid until removeScript is called for the script, clearing the profile only zeroes it
+	PawnNativeCounters& nativeCounters(int scriptID)
+	{
+		std::unique_ptr<PawnNativeCounters>& counters = natives_[scriptID];
+		if (!counters)
+		{
+			counters.reset(new PawnNativeCounters());
+		}
+		return *counters;
+	}
+
+	/// Drop the native counters of a script that is being unloaded, as its native names go with it
+	void removeScript(int scriptID)
+	{
+		natives_.erase(scriptID);
+	}
+
+	size_t sampleCount() const
+	{
+		return samples_;
+	}
+
+	/// Write every distinct stack as a "script;outer;inner count" line
+	/// @param functionName Called as functionName(scriptID, address) to get the name of the function containing
+	/// a code address, returning something convertible to StringView
+	/// @param nativeName Called as nativeName(scriptID, index) to get the name of a native
+	template <typename FunctionName, typename NativeName>
+	bool writeCollapsed(FILE* file, FunctionName&& functionName, NativeName&& nativeName) const
+	{
+		for (const auto& stack : stacks_)
+		{
+			const size_t frames = stack.first.size() / sizeof(cell);
+			const int scriptID = int(cellAt(stack.first, 0));
+			fprintf(file, "script%d", scriptID);
+			for (size_t i = 2; i < frames; ++i)
+			{
+				const StringView name = functionName(scriptID, cellAt(stack.first, i));
+				fprintf(file, ";%.*s", PRINT_VIEW(name));
+			}
+			const cell native = cellAt(stack.first, 1);
+			if (native >= 0)
+			{
+				const StringView name = nativeName(scriptID, native);
+				fprintf(file, ";%.*s", PRINT_VIEW(name));
+			}
+			fprintf(file, " %llu\n", static_cast<unsigned long long>(stack.second));
+		}
+		return !ferror(file);
+	}
+
+	/// Fill in native statistics, most expensive first
+	/// @param nativeName As in writeCollapsed, the names must stay valid until the profile is cleared
+	/// @return The total number of natives called
+	template <typename NativeName>
+	size_t getNativeStats(Span<PawnNativeStats> output, NativeName&& nativeName) const
+	{
+		struct Called
+		{
+			int scriptID;
+			cell native;
+			uint64_t calls;
+			Nanoseconds time;
+		};
+		DynamicArray<Called> called;
+		for (const auto& script : natives_)
+		{
+			const PawnNativeCounters& counters = *script.second;
+			for (size_t native = 0; native != counters.size(); ++native)
+			{
+				if (counters.calls(cell(native)))
+				{
+					called.push_back(Called { script.first, cell(native), counters.calls(cell(native)), counters.time(cell(native)) });
+				}
+			}
+		}
+		const size_t count = std::min(output.size(), called.size());
+		std::partial_sort(called.begin(), called.begin() + count, called.end(), [](const Called& a, const Called& b)
+			{
+				return a.time > b.time;
+			});
+		for (size_t i = 0; i != count; ++i)
+		{
+			output[i] = PawnNativeStats { called[i].scriptID, nativeName(called[i].scriptID, called[i].native), called[i].calls, called[i].time };
+		}
+		return called.size();
+	}
+
+	void clear()
+	{
+		stacks_.clear();
+		for (auto& script : natives_)
+		{
+			script.second->clear();
+		}
+		samples_ = 0;
+	}
+
+private:
+	static cell cellAt(const String& key, size_t index)
+	{
+		cell value;
+		std::memcpy(&value, key.data() + index * sizeof(cell), sizeof(value));
+		return value;
+	}
+
+	void append(cell value)
+	{
+		key_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	/// Stacks are keyed by their raw cells, so identical stacks hash to the same entry without a custom hasher
+	String key_;
+	FlatHashMap<String, uint64_t> stacks_;
+	/// Owned through pointers so scripts can keep references to their counters while others are added
+	FlatHashMap<int, std::unique_ptr<PawnNativeCounters>> natives_;
+	size_t samples_ = 0;
+};
+
+/// Take a sample of a script if one is due, call from the script's debug hook
+inline void samplePawnScript(PawnProfile& profile, PawnSampleClock& clock, IPawnScript& script, cell native = -1)
+{
+	if (clock.consume())
+	{
+		StaticArray<cell, PawnProfile::MaxDepth> stack;
+		const size_t depth = walkPawnStack(script, Span<cell>(stack.data(), stack.size()));
+		profile.addSample(script.GetID(), Span<const cell>(stack.data(), depth), native);
+	}
+}
+
+/// Call a native through the script's original AMX callback, timing it and sampling the stack if a sample is due
+/// @param counters The script's counters from PawnProfile::nativeCounters
+/// @param call Runs the native and returns the AMX error code
+template <typename Call>
+int profilePawnNative(PawnProfile& profile, PawnNativeCounters& counters, PawnSampleClock& clock, IPawnScript& script, cell native, Call&& call)
+{
+	samplePawnScript(profile, clock, script, native);
+	const TimePoint start = Time::now();
+	const int err = call();
+	counters.add(native, duration_cast<Nanoseconds>(Time::now() - start));
+	return err;
+}
+
+}
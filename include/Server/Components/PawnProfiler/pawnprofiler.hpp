@@ -0,0 +1,56 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <component.hpp>
+#include <types.hpp>
+
+/// How often and how long a native was called while profiling
+struct PawnNativeStats
+{
+	int scriptID; ///< The script the native was called from
+	StringView name; ///< The name of the native, valid until the profile is cleared
+	uint64_t calls; ///< The number of calls
+	Nanoseconds time; ///< The total time spent in the native
+};
+
+static const UID PawnProfilerComponent_UID = UID(0x2372b4c6a6947b25);
+struct IPawnProfilerComponent : public IComponent
+{
+	PROVIDE_UID(PawnProfilerComponent_UID);
+
+	/// Start sampling the call stacks of running scripts
+	/// Stacks are sampled from the debug hook, so scripts need to be compiled with debug information (-d1 or higher)
+	/// @param interval The time between samples
+	/// @param timeNatives Whether to also count and time every native call
+	/// @return False if the profiler is already running
+	virtual bool start(Microseconds interval, bool timeNatives) = 0;
+
+	/// Stop sampling, the samples collected so far are kept
+	virtual void stop() = 0;
+
+	/// Get whether the profiler is running
+	virtual bool running() const = 0;
+
+	/// Get the number of stacks sampled since the profile was last cleared
+	virtual size_t getSampleCount() const = 0;
+
+	/// Write the samples as collapsed stacks, one "script;caller;callee count" line per distinct stack, which flame
+	/// graph tools read directly
+	/// @return False if the file couldn't be written
+	virtual bool writeCollapsedStacks(StringView path) const = 0;
+
+	/// Get native call statistics, only collected when started with timeNatives
+	/// @param[out] output Receives up to output.size() entries, most expensive first
+	/// @return The total number of natives called, which may be more than what fit in output
+	virtual size_t getNativeStats(Span<PawnNativeStats> output) const = 0;
+
+	/// Throw away every sample and native statistic
+	virtual void clear() = 0;
+};
@@ -0,0 +1,755 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <Impl/Utils/bit_packer.hpp>
+#include <Server/Components/Vehicles/vehicles.hpp>
+#include <cmath>
+#include <types.hpp>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// Compact vehicle sync encoding for open.mp clients
+/// Positions are snapped to a 1/256 unit grid and sent as deltas against the receiver's baseline (the last
+/// state it acknowledged), quaternions are sent as their three smallest components and velocities as
+/// fixed point; fields equal to the baseline are skipped entirely.
+/// Every packet carries its own sequence number and, for deltas, the sequence number of the baseline it was
+/// encoded against, so the receiver always applies a delta to the state it was made from, and rejects it if
+/// that state is gone. Encoding is lossy, so the packet returned by encode (which is exactly what the receiver
+/// decodes) must be used as the next baseline, never the original packet. SA-MP clients always get the legacy
+/// encoding. Use SyncBaseline and SyncReceived rather than calling this directly.
+class VehicleSyncCodec
+{
+public:
+	static constexpr float PositionScale = 256.0f;
+	static constexpr float VelocityRange = 8.0f;
+	static constexpr float UnitRange = 1.0f;
+	static constexpr unsigned QuatComponentBits = 12;
+
+	/// Encode a driver sync packet
+	/// @param sequence The packet's own sequence number
+	/// @param baseline The receiver's last acknowledged state, nullptr to send a full state
+	/// @param baselineSequence The sequence number baseline was sent with, ignored without a baseline
+	/// @return The packet as the receiver will decode it
+	static VehicleDriverSyncPacket encode(const VehicleDriverSyncPacket& packet, uint16_t sequence, const VehicleDriverSyncPacket* baseline, uint16_t baselineSequence, BitPacker& out)
+	{
+		VehicleDriverSyncPacket sent = packet;
+		out.write(uint16_t(packet.PlayerID), 16);
+		out.write(packet.VehicleID, 16);
+		writeBaseline(out, sequence, baseline, baselineSequence);
+
+		if (field(out, baseline, [&](const VehicleDriverSyncPacket& base)
+				{
+					return base.LeftRight == packet.LeftRight && base.UpDown == packet.UpDown && base.Keys == packet.Keys;
+				}))
+		{
+			out.write(packet.LeftRight, 16);
+			out.write(packet.UpDown, 16);
+			out.write(packet.Keys, 16);
+		}
+		sent.Rotation = quantiseQuat(packet.Rotation);
+		if (field(out, baseline, [&](const VehicleDriverSyncPacket& base)
+				{
+					return base.Rotation.q == sent.Rotation.q;
+				}))
+		{
+			writeQuat(out, quatComponents(packet.Rotation));
+		}
+		sent.Position = writePosition(out, packet.Position, baseline ? &baseline->Position : nullptr);
+		sent.Velocity = quantise(packet.Velocity, VelocityRange);
+		if (field(out, baseline, [&](const VehicleDriverSyncPacket& base)
+				{
+					return base.Velocity == sent.Velocity;
+				}))
+		{
+			writeVector(out, packet.Velocity, VelocityRange);
+		}
+		if (field(out, baseline, [&](const VehicleDriverSyncPacket& base)
+				{
+					return base.Health == packet.Health;
+				}))
+		{
+			out.writeFloat(packet.Health);
+		}
+		sent.PlayerHealthArmour = Vector2(clampByte(packet.PlayerHealthArmour.x), clampByte(packet.PlayerHealthArmour.y));
+		if (field(out, baseline, [&](const VehicleDriverSyncPacket& base)
+				{
+					return base.PlayerHealthArmour == sent.PlayerHealthArmour;
+				}))
+		{
+			out.write(uint8_t(sent.PlayerHealthArmour.x), 8);
+			out.write(uint8_t(sent.PlayerHealthArmour.y), 8);
+		}
+		if (field(out, baseline, [&](const VehicleDriverSyncPacket& base)
+				{
+					return base.Siren == packet.Siren && base.LandingGear == packet.LandingGear && base.AdditionalKeyWeapon == packet.AdditionalKeyWeapon;
+				}))
+		{
+			out.write(packet.Siren, 8);
+			out.write(packet.LandingGear, 8);
+			out.write(packet.AdditionalKeyWeapon, 8);
+		}
+		if (field(out, baseline, [&](const VehicleDriverSyncPacket& base)
+				{
+					return base.HasTrailer == packet.HasTrailer && base.TrailerID == packet.TrailerID;
+				}))
+		{
+			out.writeBit(packet.HasTrailer);
+			out.write(packet.TrailerID, 16);
+		}
+		if (field(out, baseline, [&](const VehicleDriverSyncPacket& base)
+				{
+					return base.HydraThrustAngle == packet.HydraThrustAngle;
+				}))
+		{
+			out.write(packet.HydraThrustAngle, 32);
+		}
+		return sent;
+	}
+
+	/// Decode a driver sync packet
+	/// @param findBaseline Called as findBaseline(sequence) for deltas to get the state with that sequence number
+	/// as a const pointer, nullptr if the receiver no longer has it
+	/// @param[out] sequence The packet's sequence number
+	/// @return False if the data is malformed or the baseline is missing
+	template <typename FindBaseline>
+	static bool decode(BitUnpacker& in, FindBaseline&& findBaseline, VehicleDriverSyncPacket& packet, uint16_t& sequence)
+	{
+		const int playerID = in.read(16);
+		const uint16_t vehicleID = in.read(16);
+		if (!readBaseline(in, findBaseline, packet, sequence))
+		{
+			return false;
+		}
+		packet.PlayerID = playerID;
+		packet.VehicleID = vehicleID;
+		if (in.readBit())
+		{
+			packet.LeftRight = in.read(16);
+			packet.UpDown = in.read(16);
+			packet.Keys = in.read(16);
+		}
+		if (in.readBit())
+		{
+			packet.Rotation = quatFromComponents(readQuat(in));
+		}
+		packet.Position = readPosition(in, packet.Position);
+		if (in.readBit())
+		{
+			packet.Velocity = readVector(in, VelocityRange);
+		}
+		if (in.readBit())
+		{
+			packet.Health = in.readFloat();
+		}
+		if (in.readBit())
+		{
+			packet.PlayerHealthArmour.x = float(in.read(8));
+			packet.PlayerHealthArmour.y = float(in.read(8));
+		}
+		if (in.readBit())
+		{
+			packet.Siren = in.read(8);
+			packet.LandingGear = in.read(8);
+			packet.AdditionalKeyWeapon = in.read(8);
+		}
+		if (in.readBit())
+		{
+			packet.HasTrailer = in.readBit();
+			packet.TrailerID = in.read(16);
+		}
+		if (in.readBit())
+		{
+			packet.HydraThrustAngle = in.read(32);
+		}
+		return !in.overflow();
+	}
+
+	/// Encode a passenger sync packet
+	/// @return The packet as the receiver will decode it
+	static VehiclePassengerSyncPacket encode(const VehiclePassengerSyncPacket& packet, uint16_t sequence, const VehiclePassengerSyncPacket* baseline, uint16_t baselineSequence, BitPacker& out)
+	{
+		VehiclePassengerSyncPacket sent = packet;
+		out.write(uint16_t(packet.PlayerID), 16);
+		out.write(uint16_t(packet.VehicleID), 16);
+		writeBaseline(out, sequence, baseline, baselineSequence);
+
+		if (field(out, baseline, [&](const VehiclePassengerSyncPacket& base)
+				{
+					return base.DriveBySeatAdditionalKeyWeapon == packet.DriveBySeatAdditionalKeyWeapon;
+				}))
+		{
+			out.write(packet.DriveBySeatAdditionalKeyWeapon, 16);
+		}
+		if (field(out, baseline, [&](const VehiclePassengerSyncPacket& base)
+				{
+					return base.Keys == packet.Keys && base.LeftRight == packet.LeftRight && base.UpDown == packet.UpDown;
+				}))
+		{
+			out.write(packet.Keys, 16);
+			out.write(packet.LeftRight, 16);
+			out.write(packet.UpDown, 16);
+		}
+		sent.HealthArmour = Vector2(clampByte(packet.HealthArmour.x), clampByte(packet.HealthArmour.y));
+		if (field(out, baseline, [&](const VehiclePassengerSyncPacket& base)
+				{
+					return base.HealthArmour == sent.HealthArmour;
+				}))
+		{
+			out.write(uint8_t(sent.HealthArmour.x), 8);
+			out.write(uint8_t(sent.HealthArmour.y), 8);
+		}
+		sent.Position = writePosition(out, packet.Position, baseline ? &baseline->Position : nullptr);
+		return sent;
+	}
+
+	/// Decode a passenger sync packet
+	/// @return False if the data is malformed or the baseline is missing
+	template <typename FindBaseline>
+	static bool decode(BitUnpacker& in, FindBaseline&& findBaseline, VehiclePassengerSyncPacket& packet, uint16_t& sequence)
+	{
+		const int playerID = in.read(16);
+		const int vehicleID = in.read(16);
+		if (!readBaseline(in, findBaseline, packet, sequence))
+		{
+			return false;
+		}
+		packet.PlayerID = playerID;
+		packet.VehicleID = vehicleID;
+		if (in.readBit())
+		{
+			packet.DriveBySeatAdditionalKeyWeapon = in.read(16);
+		}
+		if (in.readBit())
+		{
+			packet.Keys = in.read(16);
+			packet.LeftRight = in.read(16);
+			packet.UpDown = in.read(16);
+		}
+		if (in.readBit())
+		{
+			packet.HealthArmour.x = float(in.read(8));
+			packet.HealthArmour.y = float(in.read(8));
+		}
+		packet.Position = readPosition(in, packet.Position);
+		return !in.overflow();
+	}
+
+	/// Encode an unoccupied sync packet
+	/// @return The packet as the receiver will decode it
+	static VehicleUnoccupiedSyncPacket encode(const VehicleUnoccupiedSyncPacket& packet, uint16_t sequence, const VehicleUnoccupiedSyncPacket* baseline, uint16_t baselineSequence, BitPacker& out)
+	{
+		VehicleUnoccupiedSyncPacket sent = packet;
+		out.write(uint16_t(packet.VehicleID), 16);
+		out.write(uint16_t(packet.PlayerID), 16);
+		out.write(packet.SeatID, 8);
+		writeBaseline(out, sequence, baseline, baselineSequence);
+
+		sent.Roll = quantise(packet.Roll, UnitRange);
+		sent.Rotation = quantise(packet.Rotation, UnitRange);
+		if (field(out, baseline, [&](const VehicleUnoccupiedSyncPacket& base)
+				{
+					return base.Roll == sent.Roll && base.Rotation == sent.Rotation;
+				}))
+		{
+			writeVector(out, packet.Roll, UnitRange);
+			writeVector(out, packet.Rotation, UnitRange);
+		}
+		sent.Position = writePosition(out, packet.Position, baseline ? &baseline->Position : nullptr);
+		sent.Velocity = quantise(packet.Velocity, VelocityRange);
+		if (field(out, baseline, [&](const VehicleUnoccupiedSyncPacket& base)
+				{
+					return base.Velocity == sent.Velocity;
+				}))
+		{
+			writeVector(out, packet.Velocity, VelocityRange);
+		}
+		sent.AngularVelocity = quantise(packet.AngularVelocity, VelocityRange);
+		if (field(out, baseline, [&](const VehicleUnoccupiedSyncPacket& base)
+				{
+					return base.AngularVelocity == sent.AngularVelocity;
+				}))
+		{
+			writeVector(out, packet.AngularVelocity, VelocityRange);
+		}
+		if (field(out, baseline, [&](const VehicleUnoccupiedSyncPacket& base)
+				{
+					return base.Health == packet.Health;
+				}))
+		{
+			out.writeFloat(packet.Health);
+		}
+		return sent;
+	}
+
+	/// Decode an unoccupied sync packet
+	/// @return False if the data is malformed or the baseline is missing
+	template <typename FindBaseline>
+	static bool decode(BitUnpacker& in, FindBaseline&& findBaseline, VehicleUnoccupiedSyncPacket& packet, uint16_t& sequence)
+	{
+		const int vehicleID = in.read(16);
+		const int playerID = in.read(16);
+		const uint8_t seatID = in.read(8);
+		if (!readBaseline(in, findBaseline, packet, sequence))
+		{
+			return false;
+		}
+		packet.VehicleID = vehicleID;
+		packet.PlayerID = playerID;
+		packet.SeatID = seatID;
+		if (in.readBit())
+		{
+			packet.Roll = readVector(in, UnitRange);
+			packet.Rotation = readVector(in, UnitRange);
+		}
+		packet.Position = readPosition(in, packet.Position);
+		if (in.readBit())
+		{
+			packet.Velocity = readVector(in, VelocityRange);
+		}
+		if (in.readBit())
+		{
+			packet.AngularVelocity = readVector(in, VelocityRange);
+		}
+		if (in.readBit())
+		{
+			packet.Health = in.readFloat();
+		}
+		return !in.overflow();
+	}
+
+	/// Encode a trailer sync packet
+	/// @return The packet as the receiver will decode it
+	static VehicleTrailerSyncPacket encode(const VehicleTrailerSyncPacket& packet, uint16_t sequence, const VehicleTrailerSyncPacket* baseline, uint16_t baselineSequence, BitPacker& out)
+	{
+		VehicleTrailerSyncPacket sent = packet;
+		out.write(uint16_t(packet.VehicleID), 16);
+		out.write(uint16_t(packet.PlayerID), 16);
+		writeBaseline(out, sequence, baseline, baselineSequence);
+
+		sent.Position = writePosition(out, packet.Position, baseline ? &baseline->Position : nullptr);
+		const StaticArray<float, 4> quat = { packet.Quat.x, packet.Quat.y, packet.Quat.z, packet.Quat.w };
+		const StaticArray<float, 4> sentQuat = quantiseQuat(quat);
+		sent.Quat = Vector4(sentQuat[0], sentQuat[1], sentQuat[2], sentQuat[3]);
+		if (field(out, baseline, [&](const VehicleTrailerSyncPacket& base)
+				{
+					return base.Quat == sent.Quat;
+				}))
+		{
+			writeQuat(out, quat);
+		}
+		sent.Velocity = quantise(packet.Velocity, VelocityRange);
+		if (field(out, baseline, [&](const VehicleTrailerSyncPacket& base)
+				{
+					return base.Velocity == sent.Velocity;
+				}))
+		{
+			writeVector(out, packet.Velocity, VelocityRange);
+		}
+		sent.TurnVelocity = quantise(packet.TurnVelocity, VelocityRange);
+		if (field(out, baseline, [&](const VehicleTrailerSyncPacket& base)
+				{
+					return base.TurnVelocity == sent.TurnVelocity;
+				}))
+		{
+			writeVector(out, packet.TurnVelocity, VelocityRange);
+		}
+		return sent;
+	}
+
+	/// Decode a trailer sync packet
+	/// @return False if the data is malformed or the baseline is missing
+	template <typename FindBaseline>
+	static bool decode(BitUnpacker& in, FindBaseline&& findBaseline, VehicleTrailerSyncPacket& packet, uint16_t& sequence)
+	{
+		const int vehicleID = in.read(16);
+		const int playerID = in.read(16);
+		if (!readBaseline(in, findBaseline, packet, sequence))
+		{
+			return false;
+		}
+		packet.VehicleID = vehicleID;
+		packet.PlayerID = playerID;
+		packet.Position = readPosition(in, packet.Position);
+		if (in.readBit())
+		{
+			const StaticArray<float, 4> quat = readQuat(in);
+			packet.Quat = Vector4(quat[0], quat[1], quat[2], quat[3]);
+		}
+		if (in.readBit())
+		{
+			packet.Velocity = readVector(in, VelocityRange);
+		}
+		if (in.readBit())
+		{
+			packet.TurnVelocity = readVector(in, VelocityRange);
+		}
+		return !in.overflow();
+	}
+
+private:
+	/// Write whether a field group changed from the baseline, returns true if it has to be written
+	template <typename Packet, typename Fn>
+	static bool field(BitPacker& out, const Packet* baseline, Fn unchanged)
+	{
+		const bool changed = baseline == nullptr || !unchanged(*baseline);
+		out.writeBit(changed);
+		return changed;
+	}
+
+	/// Write the packet's sequence number, whether it's a delta, and the baseline's sequence number if it is
+	template <typename Packet>
+	static void writeBaseline(BitPacker& out, uint16_t sequence, const Packet* baseline, uint16_t baselineSequence)
+	{
+		out.write(sequence, 16);
+		out.writeBit(baseline != nullptr);
+		if (baseline)
+		{
+			out.write(baselineSequence, 16);
+		}
+	}
+
+	template <typename Packet, typename FindBaseline>
+	static bool readBaseline(BitUnpacker& in, FindBaseline& findBaseline, Packet& packet, uint16_t& sequence)
+	{
+		sequence = in.read(16);
+		if (in.readBit())
+		{
+			const uint16_t baselineSequence = in.read(16);
+			const Packet* baseline = in.overflow() ? nullptr : findBaseline(baselineSequence);
+			if (baseline == nullptr)
+			{
+				return false;
+			}
+			packet = *baseline;
+		}
+		else
+		{
+			packet = Packet {};
+		}
+		return true;
+	}
+
+	static float clampByte(float value)
+	{
+		return float(uint8_t(glm::clamp(value, 0.0f, 255.0f)));
+	}
+
+	static int32_t toFixed(float value, float range, unsigned bits)
+	{
+		const float max = float((1 << (bits - 1)) - 1);
+		return int32_t(std::lround(glm::clamp(value / range, -1.0f, 1.0f) * max));
+	}
+
+	static float fromFixed(int32_t value, float range, unsigned bits)
+	{
+		const float max = float((1 << (bits - 1)) - 1);
+		return float(value) / max * range;
+	}
+
+	static Vector3 quantise(Vector3 value, float range)
+	{
+		return Vector3(fromFixed(toFixed(value.x, range, 16), range, 16), fromFixed(toFixed(value.y, range, 16), range, 16), fromFixed(toFixed(value.z, range, 16), range, 16));
+	}
+
+	static void writeVector(BitPacker& out, Vector3 value, float range)
+	{
+		out.writeSigned(toFixed(value.x, range, 16), 16);
+		out.writeSigned(toFixed(value.y, range, 16), 16);
+		out.writeSigned(toFixed(value.z, range, 16), 16);
+	}
+
+	static Vector3 readVector(BitUnpacker& in, float range)
+	{
+		const float x = fromFixed(in.readSigned(16), range, 16);
+		const float y = fromFixed(in.readSigned(16), range, 16);
+		const float z = fromFixed(in.readSigned(16), range, 16);
+		return Vector3(x, y, z);
+	}
+
+	/// Write a position as a 2 bit width selector followed by three deltas (or absolute values without a baseline)
+	/// of 10, 16 or 26 bits on the 1/256 grid
+	/// @return The position as the receiver will decode it
+	static Vector3 writePosition(BitPacker& out, Vector3 position, const Vector3* baseline)
+	{
+		StaticArray<int32_t, 3> grid;
+		int32_t largest = 0;
+		for (int i = 0; i != 3; ++i)
+		{
+			grid[i] = int32_t(std::lround(glm::clamp(position[i], MIN_WORLD_BOUNDS * 2.0f, MAX_WORLD_BOUNDS * 2.0f) * PositionScale));
+			if (baseline)
+			{
+				// Baselines are always on the grid so this is exact
+				grid[i] -= int32_t(std::lround((*baseline)[i] * PositionScale));
+			}
+			largest = std::max(largest, std::abs(grid[i]));
+		}
+
+		static const StaticArray<unsigned, 3> widths = { 10, 16, 26 };
+		unsigned mode = 0;
+		while (mode < 2 && largest >= (1 << (widths[mode] - 1)))
+		{
+			++mode;
+		}
+		out.write(mode, 2);
+
+		Vector3 sent;
+		for (int i = 0; i != 3; ++i)
+		{
+			out.writeSigned(grid[i], widths[mode]);
+			sent[i] = (baseline ? (*baseline)[i] : 0.0f) + float(grid[i]) / PositionScale;
+		}
+		return sent;
+	}
+
+	static Vector3 readPosition(BitUnpacker& in, Vector3 baseline)
+	{
+		static const StaticArray<unsigned, 3> widths = { 10, 16, 26 };
+		const unsigned mode = std::min(in.read(2), 2u);
+		Vector3 position;
+		for (int i = 0; i != 3; ++i)
+		{
+			position[i] = baseline[i] + float(in.readSigned(widths[mode])) / PositionScale;
+		}
+		return position;
+	}
+
+	static StaticArray<float, 4> quatComponents(const GTAQuat& quat)
+	{
+		return { quat.q.w, quat.q.x, quat.q.y, quat.q.z };
+	}
+
+	static GTAQuat quatFromComponents(const StaticArray<float, 4>& components)
+	{
+		return GTAQuat(components[0], components[1], components[2], components[3]);
+	}
+
+	static GTAQuat quantiseQuat(const GTAQuat& quat)
+	{
+		return quatFromComponents(quantiseQuat(quatComponents(quat)));
+	}
+
+	/// Get the largest component of a quaternion and the fixed point values of the other three, with the
+	/// sign flipped so the largest is positive (q and -q are the same rotation)
+	static unsigned smallestThree(const StaticArray<float, 4>& quat, StaticArray<int32_t, 3>& fixed)
+	{
+		unsigned largest = 0;
+		for (unsigned i = 1; i != 4; ++i)
+		{
+			if (std::abs(quat[i]) > std::abs(quat[largest]))
+			{
+				largest = i;
+			}
+		}
+		const float sign = quat[largest] < 0.0f ? -1.0f : 1.0f;
+		for (unsigned i = 0, j = 0; i != 4; ++i)
+		{
+			if (i != largest)
+			{
+				fixed[j++] = toFixed(quat[i] * sign * 1.41421356f, 1.0f, QuatComponentBits);
+			}
+		}
+		return largest;
+	}
+
+	static StaticArray<float, 4> fromSmallestThree(unsigned largest, const StaticArray<int32_t, 3>& fixed)
+	{
+		StaticArray<float, 4> quat;
+		float sum = 0.0f;
+		for (unsigned i = 0, j = 0; i != 4; ++i)
+		{
+			if (i != largest)
+			{
+				quat[i] = fromFixed(fixed[j++], 1.0f, QuatComponentBits) * 0.70710678f;
+				sum += quat[i] * quat[i];
+			}
+		}
+		quat[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+		return quat;
+	}
+
+	static StaticArray<float, 4> quantiseQuat(const StaticArray<float, 4>& quat)
+	{
+		StaticArray<int32_t, 3> fixed;
+		const unsigned largest = smallestThree(quat, fixed);
+		return fromSmallestThree(largest, fixed);
+	}
+
+	static void writeQuat(BitPacker& out, const StaticArray<float, 4>& quat)
+	{
+		StaticArray<int32_t, 3> fixed;
+		out.write(smallestThree(quat, fixed), 2);
+		for (int32_t value : fixed)
+		{
+			out.writeSigned(value, QuatComponentBits);
+		}
+	}
+
+	static StaticArray<float, 4> readQuat(BitUnpacker& in)
+	{
+		const unsigned largest = in.read(2);
+		StaticArray<int32_t, 3> fixed;
+		for (int32_t& value : fixed)
+		{
+			value = in.readSigned(QuatComponentBits);
+		}
+		return fromSmallestThree(largest, fixed);
+	}
+};
+
+/// Sequence numbers wrap around, a is newer than b if it's less than half the range ahead
+inline bool syncSequenceNewer(uint16_t a, uint16_t b)
+{
+	return int16_t(uint16_t(a - b)) > 0;
+}
+
+/// The sender's side of one entity's sync to one receiver: the last acknowledged state and the states sent since
+/// Sent states are tagged with a sequence number which the receiver acknowledges; only then does a state become
+/// the baseline for later deltas. Use the same History as the receiver's SyncReceived, so a baseline the sender
+/// still uses is always one the receiver still holds
+template <typename Packet, size_t History = 16>
+class SyncBaseline
+{
+public:
+	/// Encode the next packet against the current baseline and record it as sent
+	/// @return The packet's sequence number, which the receiver acknowledges
+	uint16_t encode(const Packet& packet, BitPacker& out)
+	{
+		uint16_t baselineSequence;
+		const Packet* baseline = get(baselineSequence);
+		return sent(VehicleSyncCodec::encode(packet, next_, baseline, baselineSequence, out));
+	}
+
+	/// Get the state to encode the next packet against, nullptr if nothing usable was acknowledged
+	/// A baseline more than History packets old is dropped, since the receiver might not hold it any more
+	/// @param[out] sequence The baseline's sequence number, to send with the delta
+	const Packet* get(uint16_t& sequence) const
+	{
+		sequence = baselineSequence_;
+		return hasBaseline_ && uint16_t(next_ - baselineSequence_) <= History ? &baseline_ : nullptr;
+	}
+
+	/// Record a state as encoded with the sequence number nextSequence() and get that sequence number
+	uint16_t sent(const Packet& packet)
+	{
+		const uint16_t sequence = next_++;
+		Entry& entry = history_[sequence % History];
+		entry.sequence = sequence;
+		entry.valid = true;
+		entry.packet = packet;
+		return sequence;
+	}
+
+	/// Get the sequence number the next packet will be sent with
+	uint16_t nextSequence() const
+	{
+		return next_;
+	}
+
+	/// Promote a sent state to the baseline once the receiver acknowledges it
+	/// Acknowledgements can arrive out of order, one older than the current baseline is ignored
+	/// @return False if the sequence is stale or unknown
+	bool acknowledge(uint16_t sequence)
+	{
+		Entry& entry = history_[sequence % History];
+		if (!entry.valid || entry.sequence != sequence || (hasBaseline_ && !syncSequenceNewer(sequence, baselineSequence_)))
+		{
+			return false;
+		}
+		baseline_ = entry.packet;
+		baselineSequence_ = sequence;
+		hasBaseline_ = true;
+		entry.valid = false;
+		return true;
+	}
+
+	/// Forget the baseline, the next packet is sent in full; call this on stream in, or when the receiver asks
+	/// for a full state because it couldn't decode a delta
+	void reset()
+	{
+		hasBaseline_ = false;
+		for (Entry& entry : history_)
+		{
+			entry.valid = false;
+		}
+	}
+
+private:
+	struct Entry
+	{
+		Packet packet;
+		uint16_t sequence = 0;
+		bool valid = false;
+	};
+
+	StaticArray<Entry, History> history_;
+	Packet baseline_;
+	uint16_t baselineSequence_ = 0;
+	uint16_t next_ = 0;
+	bool hasBaseline_ = false;
+};
+
+/// The receiver's side of one entity's sync: the last History states decoded, any of which a delta may be
+/// encoded against
+template <typename Packet, size_t History = 16>
+class SyncReceived
+{
+public:
+	/// Decode a packet and keep the result as a possible baseline
+	/// @param[out] sequence The packet's sequence number, to acknowledge
+	/// @return False if the data is malformed or the packet is a delta against a state that's no longer held, in
+	/// which case the sender should be asked for a full state
+	bool decode(BitUnpacker& in, Packet& packet, uint16_t& sequence)
+	{
+		const auto find = [this](uint16_t baseline) -> const Packet*
+		{
+			return this->find(baseline);
+		};
+		if (!VehicleSyncCodec::decode(in, find, packet, sequence))
+		{
+			return false;
+		}
+		Entry& entry = history_[sequence % History];
+		entry.sequence = sequence;
+		entry.valid = true;
+		entry.packet = packet;
+		return true;
+	}
+
+	/// Get a decoded state by its sequence number, nullptr if it's no longer held
+	const Packet* find(uint16_t sequence) const
+	{
+		const Entry& entry = history_[sequence % History];
+		return entry.valid && entry.sequence == sequence ? &entry.packet : nullptr;
+	}
+
+	/// Forget every state, call this on stream out
+	void reset()
+	{
+		for (Entry& entry : history_)
+		{
+			entry.valid = false;
+		}
+	}
+
+private:
+	struct Entry
+	{
+		Packet packet;
+		uint16_t sequence = 0;
+		bool valid = false;
+	};
+
+	StaticArray<Entry, History> history_;
+};
+
+}
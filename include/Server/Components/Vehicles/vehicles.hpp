@@ -433,6 +433,14 @@ struct IVehiclesComponent : public IPoolComponent<IVehicle>
 	virtual IVehicle* create(const VehicleSpawnData& data) = 0;
 
 	virtual IEventDispatcher<VehicleEventHandler>& getEventDispatcher() = 0;
+
+	/// Send vehicle sync to open.mp clients using the compact encoding from Impl/vehicle_sync_codec.hpp, which is
+	/// delta compressed against the last state each player acknowledged; SA-MP clients keep getting the legacy
+	/// encoding
+	virtual void setCompactSyncEnabled(bool enable) = 0;
+
+	/// Check whether the compact vehicle sync encoding is used for open.mp clients
+	virtual bool isCompactSyncEnabled() const = 0;
 };
 
 /// Player vehicle data
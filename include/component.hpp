@@ -56,6 +56,19 @@ struct IExtensible
 		return nullptr;
 	}
 
+	/// Query an extension added with addExtension by its type, without asking getExtension
+	/// These are owned by the extensible and live until they're removed or it's destroyed, so unlike the ones
+	/// getExtension returns, which the implementation may change or free at any time, they can be cached
+	/// @typeparam ExtensionT The extension type, must derive from IExtension
+	template <class ExtensionT>
+	ExtensionT* queryAddedExtension()
+	{
+		static_assert(std::is_base_of<IExtension, ExtensionT>::value, "queryAddedExtension parameter must inherit from IExtension");
+
+		auto it = miscExtensions.find(ExtensionT::ExtensionIID);
+		return it != miscExtensions.end() ? static_cast<ExtensionT*>(it->second.first) : nullptr;
+	}
+
 	/// Add an extension dynamically
 	/// @param ext The extension to add
 	/// @param autoDeleteExt Whether the extension should be automatically deleted (its freeExtension method called) on the extensible's destruction
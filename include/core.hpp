@@ -112,6 +112,10 @@ struct IConfig : public IExtensible
 
 	/// Get a variable as a bool
 	virtual bool* getBool(StringView key) = 0;
+
+	/// Check if an address is covered by any ban (exact, CIDR or wildcard) without converting it to a string
+	/// Bans are indexed (see Impl::BanIndex) so this doesn't depend on the number of bans
+	virtual bool isAddressBanned(const PeerAddress& address) const = 0;
 };
 
 /// Used for filling config parameters by Config components
@@ -391,3 +395,67 @@ private:
 	int* rate;
 	StaticArray<TimePoint, PLAYER_POOL_SIZE> last;
 };
+
+/// Helper class to get sync rate tier config properties
+/// Receivers within network.sync_near_radius of a player get all of their sync, ones within
+/// network.sync_far_radius get every network.sync_mid_divisor-th packet and the rest every
+/// network.sync_far_divisor-th packet; receivers marked as relevant (aiming at the player, in the same
+/// vehicle...) always get all of it. Decimated receivers are staggered by ID so the load is spread across ticks
+struct SyncRateConfigHelper
+{
+	SyncRateConfigHelper()
+		: nearRadius(nullptr)
+		, farRadius(nullptr)
+		, midDivisor(nullptr)
+		, farDivisor(nullptr)
+		, updates()
+	{
+	}
+
+	SyncRateConfigHelper(IConfig& config)
+		: nearRadius(config.getFloat("network.sync_near_radius"))
+		, farRadius(config.getFloat("network.sync_far_radius"))
+		, midDivisor(config.getInt("network.sync_mid_divisor"))
+		, farDivisor(config.getInt("network.sync_far_divisor"))
+		, updates()
+	{
+	}
+
+	/// Check whether any tier decimates sync, if not every receiver gets every packet
+	bool enabled() const
+	{
+		return nearRadius && farRadius && midDivisor && farDivisor && (*midDivisor > 1 || *farDivisor > 1);
+	}
+
+	/// Get how many of a player's sync packets a receiver gets one of
+	int getDivisor(float distanceSqr, bool relevant) const
+	{
+		if (relevant || !enabled() || distanceSqr <= *nearRadius * *nearRadius)
+		{
+			return 1;
+		}
+		return std::max(1, distanceSqr <= *farRadius * *farRadius ? *midDivisor : *farDivisor);
+	}
+
+	/// Count a sync packet received from a player, call this once before the shouldSync checks for its receivers
+	void onSync(int pid)
+	{
+		++updates[pid];
+	}
+
+	/// Check whether a receiver should get the current sync packet of a player
+	/// @param distanceSqr The squared distance between the two players
+	/// @param relevant Whether the receiver needs full rate sync regardless of distance
+	bool shouldSync(int pid, int receiverPid, float distanceSqr, bool relevant) const
+	{
+		const int divisor = getDivisor(distanceSqr, relevant);
+		return divisor == 1 || (updates[pid] + unsigned(receiverPid)) % unsigned(divisor) == 0;
+	}
+
+private:
+	float* nearRadius;
+	float* farRadius;
+	int* midDivisor;
+	int* farDivisor;
+	StaticArray<unsigned, PLAYER_POOL_SIZE> updates;
+};
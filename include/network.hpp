@@ -5,8 +5,10 @@
 #include "gtaquat.hpp"
 #include "types.hpp"
 #include "values.hpp"
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -68,7 +70,8 @@ enum NewConnectionResult
 	NewConnectionResult_BadName,
 	NewConnectionResult_BadMod,
 	NewConnectionResult_NoPlayerSlot,
-	NewConnectionResult_Success
+	NewConnectionResult_Success,
+	NewConnectionResult_RateLimited ///< Too many connection attempts from the same source, see Impl::ConnectionLimiter
 };
 
 enum class ClientVersion : uint8_t
@@ -170,14 +173,86 @@ struct PeerAddress
 		} v6;
 	};
 
+	/// A compact form of an address for use as a key in sorted or hashed containers
+	/// IPv4 addresses are stored IPv4-mapped (::ffff:a.b.c.d), so an IPv4 address and its mapped IPv6 form have the same key
+	struct Key
+	{
+		uint64_t hi; ///< The first 8 bytes of the address, big endian
+		uint64_t lo; ///< The last 8 bytes of the address, big endian
+
+		bool operator<(const Key& other) const
+		{
+			return hi < other.hi || (hi == other.hi && lo < other.lo);
+		}
+
+		bool operator==(const Key& other) const
+		{
+			return hi == other.hi && lo == other.lo;
+		}
+
+		bool operator!=(const Key& other) const
+		{
+			return !(*this == other);
+		}
+
+		/// Mix both halves into a well distributed hash
+		size_t hash() const
+		{
+			uint64_t h = hi ^ (lo * 0x9E3779B97F4A7C15ull);
+			h ^= h >> 32;
+			h *= 0xD6E8FEB86659FD93ull;
+			h ^= h >> 32;
+			return size_t(h);
+		}
+	};
+
+	/// Get the compact key of the address
+	Key key() const
+	{
+		Key key { 0, 0 };
+		if (ipv6)
+		{
+			for (int i = 0; i < 8; ++i)
+			{
+				key.hi = (key.hi << 8) | v6.bytes[i];
+				key.lo = (key.lo << 8) | v6.bytes[i + 8];
+			}
+		}
+		else
+		{
+			// v4 is in network order, so its bytes are already the address octets in order
+			const uint8_t* octets = reinterpret_cast<const uint8_t*>(&v4);
+			key.lo = 0xFFFF00000000ull | (uint64_t(octets[0]) << 24) | (uint64_t(octets[1]) << 16) | (uint64_t(octets[2]) << 8) | uint64_t(octets[3]);
+		}
+		return key;
+	}
+
+	/// Order IPv4 addresses before IPv6 addresses, then by address
 	bool operator<(const PeerAddress& other) const
 	{
-		return ipv6 < other.ipv6 && v4 < other.v4 && v6.segments[2] < other.v6.segments[2] && v6.segments[3] < other.v6.segments[3] && v6.segments[4] < other.v6.segments[4] && v6.segments[5] < other.v6.segments[5] && v6.segments[6] < other.v6.segments[6] && v6.segments[7] < other.v6.segments[7];
+		if (ipv6 != other.ipv6)
+		{
+			return other.ipv6;
+		}
+		return key() < other.key();
 	}
 
 	bool operator==(const PeerAddress& other) const
 	{
-		return ipv6 == other.ipv6 && v4 == other.v4 && v6.segments[2] == other.v6.segments[2] && v6.segments[3] == other.v6.segments[3] && v6.segments[4] == other.v6.segments[4] && v6.segments[5] == other.v6.segments[5] && v6.segments[6] == other.v6.segments[6] && v6.segments[7] == other.v6.segments[7];
+		if (ipv6 != other.ipv6)
+		{
+			return false;
+		}
+		if (ipv6)
+		{
+			return std::equal(std::begin(v6.bytes), std::end(v6.bytes), std::begin(other.v6.bytes));
+		}
+		return v4 == other.v4;
+	}
+
+	bool operator!=(const PeerAddress& other) const
+	{
+		return !(*this == other);
 	}
 
 	/// Get an address from string
@@ -242,6 +317,28 @@ struct PeerAddress
 	}
 };
 
+namespace std
+{
+template <>
+struct hash<PeerAddress::Key>
+{
+	size_t operator()(const PeerAddress::Key& key) const noexcept
+	{
+		return key.hash();
+	}
+};
+
+template <>
+struct hash<PeerAddress>
+{
+	size_t operator()(const PeerAddress& address) const noexcept
+	{
+		// Keep IPv4 and mapped IPv6 forms apart since they don't compare equal as PeerAddress
+		return address.key().hash() ^ size_t(address.ipv6);
+	}
+};
+}
+
 struct BanEntry
 {
 public:
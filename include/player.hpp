@@ -1042,6 +1042,15 @@ struct PlayerUpdateEventHandler
 	virtual bool onPlayerUpdate(IPlayer& player, TimePoint now) { return true; }
 };
 
+/// A batched alternative to PlayerUpdateEventHandler, dispatched once per tick
+/// Unlike onPlayerUpdate it's called after the sync has been applied and broadcast, so it can't block it;
+/// handlers that need to veto sync must stay on PlayerUpdateEventHandler
+struct PlayerUpdateBatchEventHandler
+{
+	/// @param players Every player that sent sync since the last tick, each once, in ID order
+	virtual void onPlayerUpdates(Span<IPlayer* const> players, TimePoint now) { }
+};
+
 /// A player pool interface
 struct IPlayerPool : public IExtensible, public IReadOnlyPool<IPlayer>
 {
@@ -1123,4 +1132,56 @@ struct IPlayerPool : public IExtensible, public IReadOnlyPool<IPlayer>
 
 	/// Get the colour assigned to a player ID when it first connects.
 	virtual Colour getDefaultColour(int pid) const = 0;
+
+	/// Get a player by name, ignoring case
+	/// Names are kept in an index updated on connect, disconnect and name change, so this doesn't scan the pool
+	/// @return The player or nullptr if no player has that name
+	virtual IPlayer* getPlayerByName(StringView name) = 0;
+
+	/// Find the players whose names start with a prefix, ignoring case, in name order
+	/// @param[out] output Receives up to output.size() players
+	/// @return The total number of matching players, which may be more than what fit in output
+	virtual size_t findPlayersByNamePrefix(StringView prefix, Span<IPlayer*> output) = 0;
+
+	/// Returns a dispatcher to the batched PlayerUpdateBatchEvent.
+	/// The batch is only collected while the dispatcher has handlers, so it costs nothing when unused
+	virtual IEventDispatcher<PlayerUpdateBatchEventHandler>& getPlayerUpdateBatchDispatcher() = 0;
+
+	/// sendClientMessage for a group of players
+	/// The RPC is encoded once per client text encoding and the same buffer is sent to every player, the *ToAll
+	/// functions do the same; pair with Impl::MessageBuilder to format without allocating
+	virtual void sendClientMessageToPlayers(Span<IPlayer* const> players, const Colour& colour, StringView message) = 0;
+
+	/// sendGameText for a group of players, encoded once like sendClientMessageToPlayers
+	virtual void sendGameTextToPlayers(Span<IPlayer* const> players, StringView message, Milliseconds time, int style) = 0;
+};
+
+/// Read-only per-tick snapshots of frequently read player fields, queried from IPlayerPool
+/// Each span is indexed by player ID and has PLAYER_POOL_SIZE elements; they are refreshed once per tick
+/// after incoming sync is processed, so components can scan them with plain loops instead of making a
+/// virtual call per player per field. Values are only meaningful where isPresent() is non-zero
+static const UID PlayerPoolSnapshot_UID = UID(0x5106cd9f0d16e688);
+struct IPlayerPoolSnapshot : public IExtension
+{
+	PROVIDE_EXT_UID(PlayerPoolSnapshot_UID);
+
+	/// Get the core tick count when the snapshot was taken
+	virtual unsigned getSnapshotTick() const = 0;
+
+	/// Non-zero for each ID that held a player (or bot) when the snapshot was taken
+	virtual Span<const uint8_t> isPresent() const = 0;
+
+	virtual Span<const Vector3> getPositions() const = 0;
+
+	virtual Span<const Vector3> getVelocities() const = 0;
+
+	virtual Span<const PlayerState> getStates() const = 0;
+
+	virtual Span<const int> getVirtualWorlds() const = 0;
+
+	virtual Span<const unsigned> getInteriors() const = 0;
+
+	virtual Span<const float> getHealths() const = 0;
+
+	virtual Span<const float> getArmours() const = 0;
 };
@@ -0,0 +1,111 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+// Checks the batch GTAQuat conversions in Impl/Utils/quat_batch.hpp against the scalar ones in gtaquat.hpp
+
+#include <Impl/Utils/quat_batch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+
+/// How far batch quaternion components may be from the scalar conversion, GTAQuat's own epsilon
+constexpr float QuatTolerance = 0.00000202655792236328125f;
+
+/// How far batch Euler angles may be from the scalar conversion, in degrees
+constexpr float EulerTolerance = 0.001f;
+
+float angleDifference(float a, float b)
+{
+	const float diff = std::fmod(std::abs(a - b), 360.0f);
+	return std::min(diff, 360.0f - diff);
+}
+
+Impl::DynamicArray<Vector3> testAngles()
+{
+	Impl::DynamicArray<Vector3> angles;
+	// Multiples of 45 degrees hit the quadrant boundaries of the sine and cosine reduction
+	for (int x = -8; x <= 8; ++x)
+	{
+		for (int y = -8; y <= 8; ++y)
+		{
+			for (int z = -8; z <= 8; ++z)
+			{
+				angles.emplace_back(x * 45.0f, y * 45.0f, z * 45.0f);
+			}
+		}
+	}
+	// Around gimbal lock, where ToEuler switches formulas
+	for (float offset : { 0.0f, 0.0001f, 0.001f, 0.01f, 0.1f })
+	{
+		for (float pitch : { 90.0f, -90.0f, 270.0f })
+		{
+			angles.emplace_back(pitch + offset, 33.0f, 12.0f);
+			angles.emplace_back(pitch - offset, -71.0f, 140.0f);
+		}
+	}
+	std::mt19937 rng(5);
+	std::uniform_real_distribution<float> random(-720.0f, 720.0f);
+	// An odd count so the scalar tail of the batch functions is covered too
+	for (int i = 0; i != 100001; ++i)
+	{
+		angles.emplace_back(random(rng), random(rng), random(rng));
+	}
+	return angles;
+}
+
+}
+
+int main()
+{
+	const Impl::DynamicArray<Vector3> angles = testAngles();
+	const size_t count = angles.size();
+	int failures = 0;
+
+	Impl::DynamicArray<GTAQuat> quats(count);
+	Impl::eulerToQuats(Span<const Vector3>(angles.data(), count), Span<GTAQuat>(quats.data(), count));
+	Impl::DynamicArray<GTAQuat> expectedQuats(count);
+	float worstQuat = 0.0f;
+	for (size_t i = 0; i != count; ++i)
+	{
+		expectedQuats[i] = GTAQuat(angles[i]);
+		const glm::quat& a = quats[i].q;
+		const glm::quat& b = expectedQuats[i].q;
+		const float error = std::max({ std::abs(a.w - b.w), std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z) });
+		worstQuat = std::max(worstQuat, error);
+		if (!(error <= QuatTolerance) && failures++ < 10)
+		{
+			printf("eulerToQuats(%g, %g, %g) is off by %g\n", angles[i].x, angles[i].y, angles[i].z, error);
+		}
+	}
+
+	Impl::DynamicArray<Vector3> eulers(count);
+	Impl::quatsToEuler(Span<const GTAQuat>(expectedQuats.data(), count), Span<Vector3>(eulers.data(), count));
+	float worstEuler = 0.0f;
+	for (size_t i = 0; i != count; ++i)
+	{
+		const Vector3 expected = expectedQuats[i].ToEuler();
+		for (int axis = 0; axis != 3; ++axis)
+		{
+			const float error = angleDifference(eulers[i][axis], expected[axis]);
+			worstEuler = std::max(worstEuler, error);
+			// Like the scalar mod, a tiny negative angle can round up to exactly 360
+			const bool inRange = eulers[i][axis] >= 0.0f && eulers[i][axis] <= 360.0f;
+			if ((!(error <= EulerTolerance) || !inRange) && failures++ < 10)
+			{
+				printf("quatsToEuler of (%g, %g, %g) gave %g on axis %d, expected %g\n", angles[i].x, angles[i].y, angles[i].z, eulers[i][axis], axis, expected[axis]);
+			}
+		}
+	}
+
+	printf("%zu conversions, worst quaternion error %g, worst Euler error %g degrees\n", count, worstQuat, worstEuler);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,79 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+// Times the batch GTAQuat conversions in Impl/Utils/quat_batch.hpp against the scalar ones in gtaquat.hpp
+
+#include <Impl/Utils/quat_batch.hpp>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+
+constexpr size_t Count = 200000;
+constexpr int Rounds = 20;
+
+template <typename Fn>
+double milliseconds(Fn&& fn)
+{
+	const TimePoint start = Time::now();
+	for (int i = 0; i != Rounds; ++i)
+	{
+		fn();
+	}
+	return std::chrono::duration<double, std::milli>(Time::now() - start).count() / Rounds;
+}
+
+}
+
+int main()
+{
+	std::mt19937 rng(5);
+	std::uniform_real_distribution<float> random(-720.0f, 720.0f);
+	Impl::DynamicArray<Vector3> angles(Count);
+	for (Vector3& angle : angles)
+	{
+		angle = Vector3(random(rng), random(rng), random(rng));
+	}
+	Impl::DynamicArray<GTAQuat> quats(Count);
+	Impl::DynamicArray<Vector3> eulers(Count);
+	// Keeps the scalar loops from being optimised away
+	volatile float sink = 0.0f;
+
+	const double batchToQuat = milliseconds([&]()
+		{
+			Impl::eulerToQuats(Span<const Vector3>(angles.data(), Count), Span<GTAQuat>(quats.data(), Count));
+			sink = sink + quats[Count / 2].q.w;
+		});
+	const double scalarToQuat = milliseconds([&]()
+		{
+			for (size_t i = 0; i != Count; ++i)
+			{
+				quats[i] = GTAQuat(angles[i]);
+			}
+			sink = sink + quats[Count / 2].q.w;
+		});
+	const double batchToEuler = milliseconds([&]()
+		{
+			Impl::quatsToEuler(Span<const GTAQuat>(quats.data(), Count), Span<Vector3>(eulers.data(), Count));
+			sink = sink + eulers[Count / 2].x;
+		});
+	const double scalarToEuler = milliseconds([&]()
+		{
+			for (size_t i = 0; i != Count; ++i)
+			{
+				eulers[i] = quats[i].ToEuler();
+			}
+			sink = sink + eulers[Count / 2].x;
+		});
+
+	printf("%zu conversions, milliseconds per round\n", Count);
+	printf("Euler to quaternion: batch %.2f, scalar %.2f (%.1fx)\n", batchToQuat, scalarToQuat, scalarToQuat / batchToQuat);
+	printf("Quaternion to Euler: batch %.2f, scalar %.2f (%.1fx)\n", batchToEuler, scalarToEuler, scalarToEuler / batchToEuler);
+	return 0;
+}
@@ -0,0 +1,360 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2026, open.mp team and contributors.
+ */
+
+// Round trips packets through the compact vehicle sync codec in Vehicles/Impl/vehicle_sync_codec.hpp
+
+#include <Server/Components/Vehicles/Impl/vehicle_sync_codec.hpp>
+#include <cstdio>
+#include <deque>
+
+using namespace Impl;
+
+namespace
+{
+
+int failures = 0;
+
+void check(bool ok, const char* what, int line)
+{
+	if (!ok)
+	{
+		if (failures < 20)
+		{
+			printf("line %d: %s\n", line, what);
+		}
+		++failures;
+	}
+}
+
+#define CHECK(expr) check((expr), #expr, __LINE__)
+
+/// The largest rounding error of a position on the 1/256 grid
+constexpr float PositionError = 0.5f / VehicleSyncCodec::PositionScale + 0.0001f;
+
+/// The largest rounding error of a 16 bit fixed point velocity
+constexpr float VelocityError = VehicleSyncCodec::VelocityRange / 32767.0f;
+
+/// The largest error of a component of a smallest three quaternion
+constexpr float QuatError = 0.001f;
+
+bool near(Vector3 a, Vector3 b, float error)
+{
+	return std::abs(a.x - b.x) <= error && std::abs(a.y - b.y) <= error && std::abs(a.z - b.z) <= error;
+}
+
+/// q and -q are the same rotation, the codec sends whichever has a positive largest component
+bool sameRotation(const glm::quat& a, const glm::quat& b, float error)
+{
+	const float sign = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z < 0.0f ? -1.0f : 1.0f;
+	return std::abs(a.w - sign * b.w) <= error && std::abs(a.x - sign * b.x) <= error && std::abs(a.y - sign * b.y) <= error && std::abs(a.z - sign * b.z) <= error;
+}
+
+/// Decoding must give exactly what encode said the receiver would see, or later deltas drift
+bool same(const VehicleDriverSyncPacket& a, const VehicleDriverSyncPacket& b)
+{
+	return a.PlayerID == b.PlayerID && a.VehicleID == b.VehicleID && a.LeftRight == b.LeftRight && a.UpDown == b.UpDown && a.Keys == b.Keys
+		&& a.Rotation.q == b.Rotation.q && a.Position == b.Position && a.Velocity == b.Velocity && a.Health == b.Health
+		&& a.PlayerHealthArmour == b.PlayerHealthArmour && a.Siren == b.Siren && a.LandingGear == b.LandingGear
+		&& a.TrailerID == b.TrailerID && a.HasTrailer == b.HasTrailer && a.AdditionalKeyWeapon == b.AdditionalKeyWeapon
+		&& a.HydraThrustAngle == b.HydraThrustAngle;
+}
+
+VehicleDriverSyncPacket driver(int step)
+{
+	VehicleDriverSyncPacket packet {};
+	packet.PlayerID = 7;
+	packet.VehicleID = 12;
+	packet.Keys = step & 3;
+	packet.LeftRight = 128;
+	packet.Rotation = GTAQuat(Vector3(0.0f, 0.0f, float(step % 360)));
+	packet.Position = Vector3(1000.0f + step * 0.37f, -2000.0f + step * 0.11f, 13.5f);
+	packet.Velocity = Vector3(0.37f, 0.11f, 0.0f);
+	packet.Health = 1000.0f - float(step / 50);
+	packet.PlayerHealthArmour = Vector2(100.0f, 50.0f);
+	packet.HydraThrustAngle = 0x12345678;
+	return packet;
+}
+
+Span<const uint8_t> copy(BitPacker& out, DynamicArray<uint8_t>& storage)
+{
+	const Span<const uint8_t> bytes = out.bytes();
+	storage.assign(bytes.begin(), bytes.end());
+	return Span<const uint8_t>(storage.data(), storage.size());
+}
+
+void fullAndDeltaFrames()
+{
+	const VehicleDriverSyncPacket first = driver(0);
+	BitPacker full;
+	const VehicleDriverSyncPacket sentFull = VehicleSyncCodec::encode(first, 5, nullptr, 0, full);
+	const size_t fullBits = full.bitCount();
+	DynamicArray<uint8_t> storage;
+	BitUnpacker fullIn(copy(full, storage));
+	VehicleDriverSyncPacket decoded;
+	uint16_t sequence = 0;
+	bool asked = false;
+	const auto none = [&](uint16_t) -> const VehicleDriverSyncPacket*
+	{
+		asked = true;
+		return nullptr;
+	};
+	CHECK(VehicleSyncCodec::decode(fullIn, none, decoded, sequence));
+	CHECK(!asked);
+	CHECK(sequence == 5);
+	CHECK(same(decoded, sentFull));
+	CHECK(near(decoded.Position, first.Position, PositionError));
+	CHECK(near(decoded.Velocity, first.Velocity, VelocityError));
+	CHECK(sameRotation(decoded.Rotation.q, first.Rotation.q, QuatError));
+
+	// Nothing changed, so the delta is the header, one bit per field group and a zero position delta
+	BitPacker unchanged;
+	VehicleSyncCodec::encode(first, 6, &sentFull, 5, unchanged);
+	CHECK(unchanged.bitCount() * 3 < fullBits);
+
+	const VehicleDriverSyncPacket second = driver(1);
+	BitPacker delta;
+	const VehicleDriverSyncPacket sentDelta = VehicleSyncCodec::encode(second, 6, &sentFull, 5, delta);
+	CHECK(delta.bitCount() < fullBits);
+	uint16_t askedFor = 0;
+	const auto find = [&](uint16_t baseline) -> const VehicleDriverSyncPacket*
+	{
+		askedFor = baseline;
+		return baseline == 5 ? &decoded : nullptr;
+	};
+	BitUnpacker deltaIn(copy(delta, storage));
+	VehicleDriverSyncPacket decodedDelta;
+	CHECK(VehicleSyncCodec::decode(deltaIn, find, decodedDelta, sequence));
+	CHECK(askedFor == 5);
+	CHECK(sequence == 6);
+	CHECK(same(decodedDelta, sentDelta));
+	CHECK(near(decodedDelta.Position, second.Position, PositionError));
+
+	// The receiver no longer holds the baseline
+	BitUnpacker missingIn(copy(delta, storage));
+	CHECK(!VehicleSyncCodec::decode(missingIn, none, decodedDelta, sequence));
+
+	// Truncated data
+	BitUnpacker truncated(Span<const uint8_t>(storage.data(), 3));
+	CHECK(!VehicleSyncCodec::decode(truncated, find, decodedDelta, sequence));
+}
+
+void quantisationBounds()
+{
+	VehicleDriverSyncPacket packet = driver(0);
+	packet.Position = Vector3(MAX_WORLD_BOUNDS * 3.0f, MIN_WORLD_BOUNDS * 3.0f, 0.0f);
+	packet.Velocity = Vector3(100.0f, -100.0f, VehicleSyncCodec::VelocityRange * 0.5f);
+	packet.PlayerHealthArmour = Vector2(-5.0f, 300.0f);
+	BitPacker out;
+	const VehicleDriverSyncPacket sent = VehicleSyncCodec::encode(packet, 0, nullptr, 0, out);
+	CHECK(sent.Position.x == MAX_WORLD_BOUNDS * 2.0f);
+	CHECK(sent.Position.y == MIN_WORLD_BOUNDS * 2.0f);
+	CHECK(near(sent.Velocity, Vector3(VehicleSyncCodec::VelocityRange, -VehicleSyncCodec::VelocityRange, VehicleSyncCodec::VelocityRange * 0.5f), VelocityError));
+	CHECK(sent.PlayerHealthArmour == Vector2(0.0f, 255.0f));
+	DynamicArray<uint8_t> storage;
+	BitUnpacker in(copy(out, storage));
+	VehicleDriverSyncPacket decoded;
+	uint16_t sequence;
+	CHECK(VehicleSyncCodec::decode(
+		in, [](uint16_t) -> const VehicleDriverSyncPacket*
+		{
+			return nullptr;
+		},
+		decoded, sequence));
+	CHECK(same(decoded, sent));
+
+	// A jump across the whole world needs the widest position deltas
+	VehicleDriverSyncPacket far = packet;
+	far.Position = Vector3(MIN_WORLD_BOUNDS * 2.0f, MAX_WORLD_BOUNDS * 2.0f, 0.0f);
+	BitPacker jump;
+	const VehicleDriverSyncPacket sentJump = VehicleSyncCodec::encode(far, 1, &sent, 0, jump);
+	BitUnpacker jumpIn(copy(jump, storage));
+	CHECK(VehicleSyncCodec::decode(
+		jumpIn, [&](uint16_t) -> const VehicleDriverSyncPacket*
+		{
+			return &decoded;
+		},
+		decoded, sequence));
+	CHECK(same(decoded, sentJump));
+	CHECK(near(decoded.Position, far.Position, PositionError));
+}
+
+/// Packets arrive late and some are lost, acknowledgements lag behind, and the sequence numbers wrap around
+void streamWithWraparound()
+{
+	SyncBaseline<VehicleDriverSyncPacket> sender;
+	SyncReceived<VehicleDriverSyncPacket> receiver;
+	struct Flight
+	{
+		int step;
+		DynamicArray<uint8_t> data;
+	};
+	std::deque<Flight> inFlight;
+	std::deque<uint16_t> acks;
+	int decodedCount = 0;
+	int rejected = 0;
+	for (int step = 0; step != 70000; ++step)
+	{
+		BitPacker out;
+		CHECK(sender.encode(driver(step), out) == uint16_t(step));
+		const Span<const uint8_t> bytes = out.bytes();
+		inFlight.push_back(Flight { step, DynamicArray<uint8_t>(bytes.begin(), bytes.end()) });
+
+		if (inFlight.size() > 5 || step % 3)
+		{
+			const Flight flight = std::move(inFlight.front());
+			inFlight.pop_front();
+			if (step % 11 == 0)
+			{
+				continue;
+			}
+			BitUnpacker in(Span<const uint8_t>(flight.data.data(), flight.data.size()));
+			VehicleDriverSyncPacket decoded;
+			uint16_t received;
+			if (!receiver.decode(in, decoded, received))
+			{
+				++rejected;
+				sender.reset();
+				continue;
+			}
+			++decodedCount;
+			const VehicleDriverSyncPacket original = driver(flight.step);
+			CHECK(received == uint16_t(flight.step));
+			CHECK(near(decoded.Position, original.Position, PositionError));
+			CHECK(decoded.Health == original.Health && decoded.Keys == original.Keys);
+			acks.push_back(received);
+		}
+		if (acks.size() > 4)
+		{
+			sender.acknowledge(acks.front());
+			acks.pop_front();
+		}
+	}
+	CHECK(decodedCount > 40000);
+	CHECK(rejected == 0);
+}
+
+void staleAcknowledgements()
+{
+	SyncBaseline<VehicleDriverSyncPacket, 4> sender;
+	BitPacker out;
+	const uint16_t first = sender.encode(driver(0), out);
+	const uint16_t second = sender.encode(driver(1), out);
+	uint16_t baseline;
+	CHECK(sender.get(baseline) == nullptr);
+	CHECK(sender.acknowledge(second));
+	CHECK(sender.get(baseline) != nullptr && baseline == second);
+	// An older acknowledgement arriving late mustn't move the baseline back
+	CHECK(!sender.acknowledge(first));
+	CHECK(sender.get(baseline) != nullptr && baseline == second);
+	// Once the baseline is older than the history the receiver may have dropped it, so send in full
+	for (int i = 0; i != 4; ++i)
+	{
+		sender.encode(driver(2 + i), out);
+	}
+	CHECK(sender.get(baseline) == nullptr);
+}
+
+template <typename Packet>
+void roundTrip(const Packet& first, const Packet& second, bool (*equal)(const Packet&, const Packet&))
+{
+	SyncBaseline<Packet> sender;
+	SyncReceived<Packet> receiver;
+	DynamicArray<uint8_t> storage;
+	Packet decoded;
+	uint16_t sequence;
+
+	BitPacker full;
+	sender.encode(first, full);
+	BitUnpacker fullIn(copy(full, storage));
+	CHECK(receiver.decode(fullIn, decoded, sequence));
+	CHECK(equal(decoded, first));
+	CHECK(sender.acknowledge(sequence));
+
+	BitPacker delta;
+	sender.encode(second, delta);
+	CHECK(delta.bitCount() < full.bitCount());
+	BitUnpacker deltaIn(copy(delta, storage));
+	CHECK(receiver.decode(deltaIn, decoded, sequence));
+	CHECK(equal(decoded, second));
+}
+
+bool samePassenger(const VehiclePassengerSyncPacket& a, const VehiclePassengerSyncPacket& b)
+{
+	return a.PlayerID == b.PlayerID && a.VehicleID == b.VehicleID && a.DriveBySeatAdditionalKeyWeapon == b.DriveBySeatAdditionalKeyWeapon
+		&& a.Keys == b.Keys && a.HealthArmour == b.HealthArmour && near(a.Position, b.Position, PositionError);
+}
+
+bool sameUnoccupied(const VehicleUnoccupiedSyncPacket& a, const VehicleUnoccupiedSyncPacket& b)
+{
+	return a.VehicleID == b.VehicleID && a.PlayerID == b.PlayerID && a.SeatID == b.SeatID && near(a.Roll, b.Roll, 0.0001f)
+		&& near(a.Position, b.Position, PositionError) && near(a.Velocity, b.Velocity, VelocityError)
+		&& near(a.AngularVelocity, b.AngularVelocity, VelocityError) && a.Health == b.Health;
+}
+
+bool sameTrailer(const VehicleTrailerSyncPacket& a, const VehicleTrailerSyncPacket& b)
+{
+	const glm::quat qa(a.Quat.w, a.Quat.x, a.Quat.y, a.Quat.z);
+	const glm::quat qb(b.Quat.w, b.Quat.x, b.Quat.y, b.Quat.z);
+	return a.VehicleID == b.VehicleID && a.PlayerID == b.PlayerID && near(a.Position, b.Position, PositionError)
+		&& sameRotation(qa, qb, QuatError) && near(a.Velocity, b.Velocity, VelocityError) && near(a.TurnVelocity, b.TurnVelocity, VelocityError);
+}
+
+void otherPackets()
+{
+	VehiclePassengerSyncPacket passenger {};
+	passenger.PlayerID = 3;
+	passenger.VehicleID = 40;
+	passenger.DriveBySeatAdditionalKeyWeapon = 0x1234;
+	passenger.Keys = 8;
+	passenger.HealthArmour = Vector2(100.0f, 0.0f);
+	passenger.Position = Vector3(10.0f, 20.0f, 30.0f);
+	VehiclePassengerSyncPacket movedPassenger = passenger;
+	movedPassenger.Position.x += 1.25f;
+	roundTrip(passenger, movedPassenger, samePassenger);
+
+	VehicleUnoccupiedSyncPacket unoccupied {};
+	unoccupied.VehicleID = 41;
+	unoccupied.PlayerID = 3;
+	unoccupied.SeatID = 1;
+	unoccupied.Roll = Vector3(1.0f, 0.0f, 0.0f);
+	unoccupied.Rotation = Vector3(0.0f, 1.0f, 0.0f);
+	unoccupied.Position = Vector3(-500.0f, 300.0f, 12.0f);
+	unoccupied.Velocity = Vector3(0.5f, 0.0f, -0.1f);
+	unoccupied.Health = 650.0f;
+	VehicleUnoccupiedSyncPacket movedUnoccupied = unoccupied;
+	movedUnoccupied.Position.y -= 0.5f;
+	roundTrip(unoccupied, movedUnoccupied, sameUnoccupied);
+
+	VehicleTrailerSyncPacket trailer {};
+	trailer.VehicleID = 42;
+	trailer.PlayerID = 3;
+	trailer.Position = Vector3(2000.0f, 2000.0f, 10.0f);
+	trailer.Quat = Vector4(0.0f, 0.0f, 0.38268343f, 0.92387953f);
+	trailer.Velocity = Vector3(1.0f, 1.0f, 0.0f);
+	VehicleTrailerSyncPacket movedTrailer = trailer;
+	movedTrailer.Position += Vector3(0.1f, 0.1f, 0.0f);
+	roundTrip(trailer, movedTrailer, sameTrailer);
+}
+
+}
+
+int main()
+{
+	fullAndDeltaFrames();
+	quantisationBounds();
+	streamWithWraparound();
+	staleAcknowledgements();
+	otherPackets();
+	if (failures)
+	{
+		printf("%d checks failed\n", failures);
+		return 1;
+	}
+	printf("All checks passed\n");
+	return 0;
+}